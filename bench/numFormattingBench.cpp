@@ -0,0 +1,115 @@
+/*
+ * numFormattingBench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ *
+ *  Compare writing numbers through std::stringstream with njh::appendNum/njh::conToStr
+ *  build from the root of the repo with
+ *  g++ -std=c++17 -O2 -Isrc -I$(EXTERNAL)/cppitertools/include bench/numFormattingBench.cpp -o bin/numFormattingBench
+ */
+
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "njhcpp/common.h"
+#include "njhcpp/utils/stringUtils.hpp"
+
+namespace {
+
+template<typename FUNC>
+double timeIt(FUNC f, uint32_t reps) {
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t rep = 0; rep < reps; ++rep) {
+		f();
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename T>
+std::string streamConToStr(const std::vector<T> & con, const std::string & delim) {
+	std::stringstream out;
+	bool first = true;
+	for (const auto & e : con) {
+		if (!first) {
+			out << delim;
+		}
+		first = false;
+		out << e;
+	}
+	return out.str();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+	const size_t nValues = argc > 1 ? std::stoul(argv[1]) : 1000000;
+	const uint32_t reps = 5;
+	std::mt19937_64 gen(42);
+	std::uniform_real_distribution<double> doubleDist(-1e6, 1e6);
+	std::uniform_int_distribution<int64_t> intDist(-1000000000, 1000000000);
+	std::vector<double> doubles(nValues);
+	std::vector<int64_t> ints(nValues);
+	for (size_t pos = 0; pos < nValues; ++pos) {
+		doubles[pos] = doubleDist(gen);
+		ints[pos] = intDist(gen);
+	}
+	size_t checkSum = 0;
+	auto report = [&](const std::string & name, double streamTime, double newTime) {
+		std::cout << name << "\tstringstream: " << streamTime << "s\tto_chars: " << newTime
+				<< "s\tspeed up: " << streamTime / newTime << "x" << std::endl;
+	};
+
+	report("conToStr<double>",
+			timeIt([&]() {checkSum += streamConToStr(doubles, "\t").size();}, reps),
+			timeIt([&]() {checkSum += njh::conToStr(doubles, "\t").size();}, reps));
+	report("conToStr<int64_t>",
+			timeIt([&]() {checkSum += streamConToStr(ints, "\t").size();}, reps),
+			timeIt([&]() {checkSum += njh::conToStr(ints, "\t").size();}, reps));
+	report("to_string<double>",
+			timeIt([&]() {
+				for (const auto & d : doubles) {
+					std::stringstream ss;
+					ss << d;
+					checkSum += ss.str().size();
+				}
+			}, reps),
+			timeIt([&]() {
+				for (const auto & d : doubles) {
+					checkSum += estd::to_string(d).size();
+				}
+			}, reps));
+	//writing rows into a single reused buffer like a table writer would
+	std::string buffer;
+	buffer.reserve(1024);
+	report("row of 10 doubles, reused buffer",
+			timeIt([&]() {
+				for (size_t pos = 0; pos + 10 <= doubles.size(); pos += 10) {
+					std::stringstream ss;
+					for (size_t col = 0; col < 10; ++col) {
+						if (0 != col) {
+							ss << '\t';
+						}
+						ss << doubles[pos + col];
+					}
+					checkSum += ss.str().size();
+				}
+			}, reps),
+			timeIt([&]() {
+				for (size_t pos = 0; pos + 10 <= doubles.size(); pos += 10) {
+					buffer.clear();
+					for (size_t col = 0; col < 10; ++col) {
+						if (0 != col) {
+							buffer.push_back('\t');
+						}
+						njh::appendNum(buffer, doubles[pos + col]);
+					}
+					checkSum += buffer.size();
+				}
+			}, reps));
+	std::cout << "checksum: " << checkSum << std::endl;
+	return 0;
+}
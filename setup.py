@@ -298,6 +298,8 @@ class Packages():
             self.packages_["bamtools"] = self.__bamtools()
         if "jsoncpp" in libsNeeded:
             self.packages_["jsoncpp"] = self.__jsoncpp()
+        if "simdjson" in libsNeeded:
+            self.packages_["simdjson"] = self.__simdjson()
         if "catch" in libsNeeded:
             self.packages_["catch"] = self.__catch()
         if "hts" in libsNeeded:
@@ -460,6 +462,15 @@ class Packages():
                 pickle.dump(pack, output, pickle.HIGHEST_PROTOCOL)
         return pack
 
+    def __simdjson(self):
+        name = "simdjson"
+        buildCmd = "mkdir -p build && cd build && CC={CC} CXX={CXX} cmake -DCMAKE_BUILD_TYPE=Release -DBUILD_SHARED_LIBS=ON -DCMAKE_INSTALL_LIBDIR=lib -DCMAKE_INSTALL_PREFIX:PATH={local_dir} .. && make -j {num_cores} install"
+        pack = CPPLibPackage(name, buildCmd, self.dirMaster_, "file", "3.10.1")
+        pack.addVersion("https://github.com/simdjson/simdjson/archive/v3.10.1.tar.gz", "3.10.1")
+        #njhcpp's json::parse() and friends use simdjson when this is defined
+        pack.versions_["3.10.1"].additionalIncludeFlags_ = ["-DNJHCPP_USE_SIMDJSON"]
+        return pack
+
     def __mongoc(self):
         url = "https://github.com/mongodb/mongo-c-driver.git"
         name = "mongoc"
@@ -1931,6 +1942,7 @@ class Setup:
                        "seqserver": self.seqserver,
                        "njhrinside": self.njhRInside,
                        "jsoncpp": self.jsoncpp,
+                       "simdjson": self.simdjson,
                        "pstreams": self.pstreams,
                        "dlib": self.dlib,
                        "libsvm": self.libsvm,
@@ -2551,6 +2563,9 @@ class Setup:
     def jsoncpp(self, version):
         self.__defaultBuild("jsoncpp", version)
 
+    def simdjson(self, version):
+        self.__defaultBuild("simdjson", version)
+
     def lapack(self, version):
         self.__defaultBuild("lapack", version)
 
@@ -10,3 +10,4 @@
 #include "njhcpp/IO/InputStream.hpp"
 #include "njhcpp/IO/OutputStream.hpp"
 #include "njhcpp/IO/IOOptions.h"
+#include "njhcpp/IO/JsonRecordReader.hpp"
@@ -0,0 +1,343 @@
+#pragma once
+/*
+ * JsonRecordReader.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include "njhcpp/IO/InputStream.hpp"
+#include "njhcpp/jsonUtils/jsonUtils.hpp"
+#include "njhcpp/concurrency/concurrencyUtils.hpp"
+
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <exception>
+
+namespace njh {
+
+/**@brief Read the records of a JSON Lines (NDJSON) file or the elements of a top level JSON array one at a time,
+ * so files of any size can be gone through in bounded memory, plain or gzipped input the same as InputStream
+ *
+ * In NDJSON mode lines can be parsed on several threads in batches of Pars::batchSize_ lines, records still come
+ * back in file order and a bad line only throws once the records before it have been read.
+ *
+ */
+class JsonRecordReader {
+public:
+	enum class Format {
+		autoDetect, /**< an array if the first non-whitespace character is '[', otherwise NDJSON, NDJSON of arrays needs Format::ndjson */
+		ndjson, /**< one value per line, blank lines are skipped */
+		array /**< the elements of a top level array */
+	};
+
+	struct Pars {
+		Format format_ = Format::autoDetect;
+		uint32_t numThreads_ = 1; /**< threads for parsing NDJSON lines, arrays are always read on one thread */
+		uint32_t batchSize_ = 4096; /**< lines read and parsed at a time when numThreads_ > 1 */
+	};
+
+	explicit JsonRecordReader(const InOptions & inOpts) :
+			JsonRecordReader(inOpts, Pars()) {
+	}
+
+	JsonRecordReader(const InOptions & inOpts, const Pars & pars) :
+			pars_(pars), in_(inOpts), buffer_(1024 * 64) {
+		if (Format::autoDetect == pars_.format_) {
+			skipWhiteSpace();
+			pars_.format_ = (pos_ < end_ && '[' == buffer_[pos_]) ? Format::array : Format::ndjson;
+		}
+	}
+
+	/**@brief Read the next record
+	 *
+	 * @param record set to the record
+	 * @return false once there are no more records
+	 */
+	bool readNextRecord(Json::Value & record) {
+		if (Format::ndjson == pars_.format_ && pars_.numThreads_ > 1) {
+			return readNextParsed(record);
+		}
+		if (!readNextRecordText(text_)) {
+			return false;
+		}
+		record = parseRecord(text_, recordsRead_, recordLine_);
+		return true;
+	}
+
+	/**@brief Read the text of the next record without parsing it, e.g. to parse later or to hand to json::JsonDocument::fromString() for lazy access
+	 *
+	 * @param text set to the record's json text
+	 * @return false once there are no more records
+	 */
+	bool readNextRecordText(std::string & text) {
+		const bool ret = Format::array == pars_.format_ ? nextArrayElement(text) : nextLine(text);
+		if (ret) {
+			++recordsRead_;
+		}
+		return ret;
+	}
+
+	/**@brief The number of records read so far
+	 *
+	 */
+	uint64_t recordsRead() const {
+		return recordsRead_;
+	}
+
+	/**@brief Whether the input is being read as NDJSON or as an array, only autoDetect before anything is read
+	 *
+	 */
+	Format format() const {
+		return pars_.format_;
+	}
+
+private:
+	Pars pars_;
+	InputStream in_;
+	std::vector<char> buffer_;
+	size_t pos_ = 0;
+	size_t end_ = 0;
+	bool inputDone_ = false;
+
+	uint64_t recordsRead_ = 0;
+	uint64_t lineNumber_ = 0; /**< lines consumed so far */
+	uint64_t recordLine_ = 0; /**< the line the last record started on */
+	std::string text_;
+
+	bool arrayStarted_ = false;
+	bool arrayDone_ = false;
+
+	struct ParsedRecord {
+		Json::Value value_;
+		std::exception_ptr error_;
+	};
+	std::vector<std::string> batchText_;
+	std::vector<uint64_t> batchLines_;
+	std::vector<ParsedRecord> batch_;
+	size_t batchPos_ = 0;
+
+	bool fillBuffer() {
+		if (inputDone_) {
+			return false;
+		}
+		if (pos_ < end_ && pos_ > 0) {
+			std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+		}
+		end_ -= pos_;
+		pos_ = 0;
+		const auto got = in_.rdbuf()->sgetn(buffer_.data() + end_, buffer_.size() - end_);
+		if (got <= 0) {
+			inputDone_ = true;
+			return false;
+		}
+		end_ += got;
+		return true;
+	}
+
+	void skipWhiteSpace() {
+		while (true) {
+			while (pos_ < end_) {
+				const char c = buffer_[pos_];
+				if (' ' != c && '\t' != c && '\r' != c && '\n' != c) {
+					return;
+				}
+				if ('\n' == c) {
+					++lineNumber_;
+				}
+				++pos_;
+			}
+			if (!fillBuffer()) {
+				return;
+			}
+		}
+	}
+
+	bool nextLine(std::string & line) {
+		while (true) {
+			line.clear();
+			bool found = false;
+			while (!found) {
+				const char * start = buffer_.data() + pos_;
+				const char * newLine = static_cast<const char *>(std::memchr(start, '\n', end_ - pos_));
+				if (nullptr != newLine) {
+					line.append(start, newLine);
+					pos_ += newLine - start + 1;
+					found = true;
+				} else {
+					line.append(start, end_ - pos_);
+					pos_ = end_;
+					if (!fillBuffer()) {
+						break;
+					}
+				}
+			}
+			if (!found && line.empty()) {
+				return false;
+			}
+			++lineNumber_;
+			if (!line.empty() && '\r' == line.back()) {
+				line.pop_back();
+			}
+			if (line.find_first_not_of(" \t\r") != std::string::npos) {
+				recordLine_ = lineNumber_;
+				return true;
+			}
+		}
+	}
+
+	[[noreturn]] void throwFormatError(const std::string & what) const {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error in reading " << in_.inOpts_.inFilename_ << " around line " << lineNumber_ + 1
+				<< ", " << what << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+
+	bool nextArrayElement(std::string & text) {
+		if (arrayDone_) {
+			return false;
+		}
+		if (!arrayStarted_) {
+			skipWhiteSpace();
+			if (pos_ >= end_ || '[' != buffer_[pos_]) {
+				throwFormatError("expected the input to start with [");
+			}
+			++pos_;
+			arrayStarted_ = true;
+			skipWhiteSpace();
+			if (pos_ < end_ && ']' == buffer_[pos_]) {
+				++pos_;
+				arrayDone_ = true;
+				return false;
+			}
+		} else {
+			skipWhiteSpace();
+		}
+		recordLine_ = lineNumber_ + 1;
+		text.clear();
+		uint32_t depth = 0;
+		bool inString = false;
+		bool escaped = false;
+		while (true) {
+			size_t chunkStart = pos_;
+			for (; pos_ < end_; ++pos_) {
+				const char c = buffer_[pos_];
+				if (inString) {
+					if (escaped) {
+						escaped = false;
+					} else if ('\\' == c) {
+						escaped = true;
+					} else if ('"' == c) {
+						inString = false;
+					}
+					continue;
+				}
+				switch (c) {
+				case '"':
+					inString = true;
+					break;
+				case '[':
+				case '{':
+					++depth;
+					break;
+				case ']':
+				case '}':
+					if (0 == depth) {
+						if (']' != c) {
+							throwFormatError("unmatched }");
+						}
+						text.append(buffer_.data() + chunkStart, pos_ - chunkStart);
+						++pos_;
+						arrayDone_ = true;
+						return finishElement(text);
+					}
+					--depth;
+					break;
+				case ',':
+					if (0 == depth) {
+						text.append(buffer_.data() + chunkStart, pos_ - chunkStart);
+						++pos_;
+						return finishElement(text);
+					}
+					break;
+				case '\n':
+					++lineNumber_;
+					break;
+				default:
+					break;
+				}
+			}
+			text.append(buffer_.data() + chunkStart, pos_ - chunkStart);
+			if (!fillBuffer()) {
+				throwFormatError("the top level array isn't closed");
+			}
+		}
+	}
+
+	bool finishElement(std::string & text) {
+		const auto last = text.find_last_not_of(" \t\r\n");
+		if (std::string::npos == last) {
+			throwFormatError("empty array element");
+		}
+		text.erase(last + 1);
+		return true;
+	}
+
+	Json::Value parseRecord(const std::string & text, uint64_t recordNum, uint64_t line) const {
+		try {
+			return json::parse(text);
+		} catch (const std::exception & e) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in parsing record " << recordNum << " starting on line " << line
+					<< " of " << in_.inOpts_.inFilename_ << "\n" << e.what();
+			throw std::runtime_error { ss.str() };
+		}
+	}
+
+	bool readNextParsed(Json::Value & record) {
+		if (batchPos_ >= batch_.size() && !parseNextBatch()) {
+			return false;
+		}
+		ParsedRecord & current = batch_[batchPos_++];
+		if (current.error_) {
+			std::rethrow_exception(current.error_);
+		}
+		record = std::move(current.value_);
+		return true;
+	}
+
+	bool parseNextBatch() {
+		batchText_.resize(std::max<uint32_t>(1, pars_.batchSize_));
+		batchLines_.resize(batchText_.size());
+		const uint64_t firstRecord = recordsRead_;
+		size_t count = 0;
+		while (count < batchText_.size() && readNextRecordText(batchText_[count])) {
+			batchLines_[count] = recordLine_;
+			++count;
+		}
+		batch_.clear();
+		batch_.resize(count);
+		batchPos_ = 0;
+		if (0 == count) {
+			return false;
+		}
+		std::atomic<size_t> next { 0 };
+		std::function<void()> parseLines = [&]() {
+			size_t pos = next++;
+			while (pos < count) {
+				try {
+					batch_[pos].value_ = parseRecord(batchText_[pos], firstRecord + pos + 1, batchLines_[pos]);
+				} catch (...) {
+					batch_[pos].error_ = std::current_exception();
+				}
+				pos = next++;
+			}
+		};
+		concurrent::runVoidFunctionThreaded(parseLines, std::min<size_t>(pars_.numThreads_, count));
+		return true;
+	}
+};
+
+} /* namespace njh */
@@ -11,8 +11,12 @@
 #include <numeric>  // iota
 #include <iostream> // ostream
 #include <cstdint>  // uint32_t
+#include <cstring>  // memmove
+#include <string_view>
+#include <streambuf>
 
 #include "njhcpp/utils/stringUtils.hpp" // conToStr
+#include "njhcpp/utils/simdUtils.hpp" // simd::findChar
 
 
 namespace njh {
@@ -90,9 +94,35 @@ const std::string on_IPurple = "\033[105m"; /**< Purple high intensity backgroun
 const std::string on_ICyan =   "\033[106m"; /**< Cyan high intensity background*/
 const std::string on_IWhite =  "\033[107m"; /**< White high intensity background*/
 
-/**the regex pattern representing the bash terminal formating*/
+/**the regex pattern representing the bash terminal formating, only kept for outside code, the functions below don't use it and strip any CSI sequence*/
 const std::regex formatPattern {"\\\033\\[\\d+m"};
 
+const char escChar = '\033'; /**< the escape character that starts the terminal formatting sequences */
+
+/**@brief Get the length of the CSI escape sequence (ESC [ parameters intermediates final-byte, e.g. "\033[1m" or "\033[38;5;100m") starting at pos
+ *
+ * @param pos where the sequence would start
+ * @param end the end of the text
+ * @return the length of the sequence or 0 if there isn't a complete sequence starting at pos
+ */
+inline size_t csiSequenceLen(const char * pos, const char * end) {
+	if (end - pos < 3 || escChar != pos[0] || '[' != pos[1]) {
+		return 0;
+	}
+	for (const char * cur = pos + 2; cur != end; ++cur) {
+		const unsigned char c = static_cast<unsigned char>(*cur);
+		if (c >= 0x40 && c <= 0x7E) {
+			//final byte
+			return cur - pos + 1;
+		}
+		if (c < 0x20 || c > 0x3F) {
+			//not a parameter or intermediate byte so not a valid sequence
+			return 0;
+		}
+	}
+	return 0;
+}
+
 /**@brief Change the terminal text color to the one of the 216 available colors
  *
  * @param colorCode A number between 16 and 232 to indicate the color to be used
@@ -161,22 +191,47 @@ inline std::string boldBlack(const std::string & str) {
 	return black + bold + str + reset;
 }
 
-/**@brief Get an actual length the string will appear on the terminal
+/**@brief Get an actual length the string will appear on the terminal, i.e. the length without the terminal formatting
  *
  * @param str The string to get the length from
  * @return The printing length
  */
-inline uint32_t getPrintLen(const std::string & str) {
+inline uint32_t getPrintLen(std::string_view str) {
+	const char * const end = str.data() + str.size();
+	const char * pos = simd::findChar(str.data(), end, escChar);
+	size_t formatLen = 0;
+	while (pos != end) {
+		const size_t seqLen = csiSequenceLen(pos, end);
+		formatLen += seqLen;
+		pos = simd::findChar(pos + std::max<size_t>(seqLen, 1), end, escChar);
+	}
+	return str.size() - formatLen;
+}
 
-	std::smatch match;
-	std::regex_search(str, match, formatPattern);
-	uint32_t matchLen = match.length();
-	std::string strMatch = match.suffix().str();
-	while (std::regex_search(strMatch, match, formatPattern)) {
-		strMatch = match.suffix().str();
-		matchLen += match.length();
+/**@brief remove the terminal formatting in place, one pass moving the text between the escape sequences down
+ *
+ * @param str the string to trim
+ */
+inline void trimForNonTerminalOutInPlace(std::string & str) {
+	char * const begin = &str[0];
+	const char * const end = str.data() + str.size();
+	const char * pos = simd::findChar(str.data(), end, escChar);
+	if (end == pos) {
+		return;
 	}
-	return str.length() - matchLen;
+	char * writePos = begin + (pos - begin);
+	while (pos != end) {
+		const size_t seqLen = csiSequenceLen(pos, end);
+		const char * segStart = pos + seqLen;
+		const char * segEnd = simd::findChar(segStart + (0 == seqLen ? 1 : 0), end, escChar);
+		const size_t segLen = segEnd - segStart;
+		if (writePos != segStart) {
+			std::memmove(writePos, segStart, segLen);
+		}
+		writePos += segLen;
+		pos = segEnd;
+	}
+	str.resize(writePos - begin);
 }
 
 /**@brief remove the terminal formatting for printing to files and such
@@ -184,10 +239,135 @@ inline uint32_t getPrintLen(const std::string & str) {
  * @param str the string to trim
  * @return A string with no formating
  */
-inline std::string trimForNonTerminalOut(const std::string & str){
-	return std::regex_replace(str, formatPattern, "");
+inline std::string trimForNonTerminalOut(std::string_view str){
+	std::string ret;
+	const char * const end = str.data() + str.size();
+	const char * pos = simd::findChar(str.data(), end, escChar);
+	if (end == pos) {
+		return std::string(str);
+	}
+	ret.reserve(str.size());
+	ret.append(str.data(), pos - str.data());
+	while (pos != end) {
+		const size_t seqLen = csiSequenceLen(pos, end);
+		const char * segStart = pos + seqLen;
+		const char * segEnd = simd::findChar(segStart + (0 == seqLen ? 1 : 0), end, escChar);
+		ret.append(segStart, segEnd - segStart);
+		pos = segEnd;
+	}
+	return ret;
 }
 
+/**@brief A std::streambuf that removes the terminal formatting from what's written to it before passing it on to another streambuf,
+ * escape sequences split across writes are handled, e.g. std::ostream out(&filter); out << proc.out().rdbuf();
+ *
+ */
+class AnsiStripStreamBuf : public std::streambuf {
+public:
+	/**@brief Construct with the streambuf to write the trimmed text to, it has to outlive this
+	 *
+	 * @param dest where the text goes
+	 */
+	explicit AnsiStripStreamBuf(std::streambuf * dest) :
+			dest_(dest) {
+	}
+
+	~AnsiStripStreamBuf() {
+		flushPending();
+	}
+
+protected:
+	std::streamsize xsputn(const char * s, std::streamsize n) override {
+		const char * pos = s;
+		const char * const end = s + n;
+		while (pos != end) {
+			if (State::NORMAL == state_) {
+				const char * esc = simd::findChar(pos, end, escChar);
+				if (esc != pos && dest_->sputn(pos, esc - pos) != esc - pos) {
+					return -1;
+				}
+				pos = esc;
+				if (end == pos) {
+					break;
+				}
+			}
+			if (!putChar(*pos)) {
+				return -1;
+			}
+			++pos;
+		}
+		return n;
+	}
+
+	int_type overflow(int_type c) override {
+		if (traits_type::eq_int_type(c, traits_type::eof())) {
+			return traits_type::not_eof(c);
+		}
+		return putChar(traits_type::to_char_type(c)) ? c : traits_type::eof();
+	}
+
+	/**@brief a partial escape sequence is held back until it's known whether it's complete so sync doesn't flush it
+	 *
+	 */
+	int sync() override {
+		return dest_->pubsync();
+	}
+
+private:
+	enum class State {
+		NORMAL, ESC, CSI
+	};
+
+	std::streambuf * dest_;
+	State state_ = State::NORMAL;
+	std::string pending_; /**< the start of an escape sequence that hasn't ended yet */
+
+	bool flushPending() {
+		state_ = State::NORMAL;
+		if (pending_.empty()) {
+			return true;
+		}
+		const std::streamsize len = pending_.size();
+		const bool ok = dest_->sputn(pending_.data(), len) == len;
+		pending_.clear();
+		return ok;
+	}
+
+	bool putChar(char c) {
+		const unsigned char uc = static_cast<unsigned char>(c);
+		switch (state_) {
+		case State::NORMAL:
+			if (escChar == c) {
+				pending_.push_back(c);
+				state_ = State::ESC;
+				return true;
+			}
+			return !traits_type::eq_int_type(dest_->sputc(c), traits_type::eof());
+		case State::ESC:
+			if ('[' == c) {
+				pending_.push_back(c);
+				state_ = State::CSI;
+				return true;
+			}
+			break;
+		case State::CSI:
+			if (uc >= 0x40 && uc <= 0x7E) {
+				//complete sequence, drop it
+				pending_.clear();
+				state_ = State::NORMAL;
+				return true;
+			}
+			if (uc >= 0x20 && uc <= 0x3F) {
+				pending_.push_back(c);
+				return true;
+			}
+			break;
+		}
+		//not a valid sequence, write it out as is and then handle c as normal text
+		return flushPending() && putChar(c);
+	}
+};
+
 } // namespace bashCT
 
 /**@brief Return a string with the text centered for the max width of the line
@@ -8,5 +8,6 @@
 
 #include "njhcpp/common/stdIncludes.hpp"
 #include "njhcpp/common/stdAdditions.hpp"
+#include "njhcpp/common/numFormatting.hpp"
 #include "njhcpp/common/misc.hpp"
 
@@ -8,6 +8,7 @@
 
 
 #include "njhcpp/common/stdIncludes.hpp"
+#include "njhcpp/common/numFormatting.hpp"
 
 namespace estd {
 /**@brief simply aesthetic, to make call to is_arithmetic look nicer
@@ -52,16 +53,21 @@ constexpr bool isString(){
 }
 
 
-/**@brief Templated function to pass anything to string as long as it has an << operator
+/**@brief Templated function to pass anything to string as long as it has an << operator, numbers skip the stream
+ * and are written with njh::numToStr (same output as the stream's default formatting)
  *
  * @param e Element to change to a string
  * @return The element changed into a string
  */
 template <typename T>
 std::string to_string(const T & e) {
-  std::stringstream ss;
-  ss << e;
-  return ss.str();
+  if constexpr (njh::isFormattableNum<T>()) {
+    return njh::numToStr(e);
+  } else {
+    std::stringstream ss;
+    ss << e;
+    return ss.str();
+  }
 }
 
 template <>
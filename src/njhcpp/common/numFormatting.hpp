@@ -0,0 +1,165 @@
+#pragma once
+/*
+ * numFormatting.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <charconv> //std::to_chars
+#include <string>
+#include <type_traits>
+#include <limits>
+#include <system_error> //std::errc
+#include <cstdio> //snprintf
+#include <sstream>
+#include <iomanip>
+#include <locale>
+#include <stdexcept>
+
+namespace njh {
+
+/**@brief Whether T is a number that std::ostream writes out as digits, i.e. integer and floating point types except bool and the character types
+ *
+ */
+template<typename T>
+constexpr bool isFormattableNum() {
+	using Decayed = typename std::decay<T>::type;
+	return (std::is_integral<Decayed>::value
+			&& !std::is_same<bool, Decayed>::value
+			&& !std::is_same<char, Decayed>::value
+			&& !std::is_same<signed char, Decayed>::value
+			&& !std::is_same<unsigned char, Decayed>::value
+			&& !std::is_same<wchar_t, Decayed>::value
+			&& !std::is_same<char16_t, Decayed>::value
+			&& !std::is_same<char32_t, Decayed>::value)
+			|| std::is_floating_point<Decayed>::value;
+}
+
+/**@brief How to write floating point numbers
+ *
+ */
+enum class FloatFormat {
+	GENERAL, /**< printf's %g, with the default precision of 6 this is exactly what std::ostream writes by default */
+	SHORTEST, /**< the shortest string that reads back to exactly the same value, precision is ignored */
+	FIXED, /**< printf's %f, precision is the number of digits after the decimal point */
+	SCIENTIFIC /**< printf's %e, precision is the number of digits after the decimal point */
+};
+
+namespace impl {
+
+#if !defined(__cpp_lib_to_chars)
+template<typename T>
+int snprintfFloat(char * buffer, size_t size, T val, FloatFormat format, int precision) {
+	const long double asLong = val;
+	switch (format) {
+	case FloatFormat::SHORTEST:
+		return std::snprintf(buffer, size, "%.*Lg", std::numeric_limits<T>::max_digits10, asLong);
+	case FloatFormat::FIXED:
+		return std::snprintf(buffer, size, "%.*Lf", precision, asLong);
+	case FloatFormat::SCIENTIFIC:
+		return std::snprintf(buffer, size, "%.*Le", precision, asLong);
+	case FloatFormat::GENERAL:
+	default:
+		return std::snprintf(buffer, size, "%.*Lg", precision, asLong);
+	}
+}
+#endif
+
+template<typename T>
+std::to_chars_result toCharsNum(char * first, char * last, T val, FloatFormat format, int precision) {
+	if constexpr (std::is_integral<T>::value) {
+		return std::to_chars(first, last, val);
+	} else {
+#if defined(__cpp_lib_to_chars)
+		switch (format) {
+		case FloatFormat::SHORTEST:
+			return std::to_chars(first, last, val);
+		case FloatFormat::FIXED:
+			return std::to_chars(first, last, val, std::chars_format::fixed, precision);
+		case FloatFormat::SCIENTIFIC:
+			return std::to_chars(first, last, val, std::chars_format::scientific, precision);
+		case FloatFormat::GENERAL:
+		default:
+			return std::to_chars(first, last, val, std::chars_format::general, precision);
+		}
+#else
+		//no floating point to_chars in this standard library, fall back on snprintf which at least skips the stream and its locale
+		const int written = snprintfFloat(first, last - first, val, format, precision);
+		if (written < 0 || written >= last - first) {
+			return std::to_chars_result { last, std::errc::value_too_large };
+		}
+		return std::to_chars_result { first + written, std::errc() };
+#endif
+	}
+}
+
+}  // namespace impl
+
+/**@brief Append the text of a number onto the end of out without any intermediate strings or streams, meant to be used with a
+ * reused, pre-reserved buffer e.g. when writing out rows of a table
+ *
+ * @param out the string to append to
+ * @param val the number
+ * @param format how to write floating point numbers, ignored for integers
+ * @param precision the precision for floating point numbers (6 is the std::ostream default), ignored for integers and FloatFormat::SHORTEST
+ */
+template<typename T>
+void appendNum(std::string & out, T val, FloatFormat format = FloatFormat::GENERAL, int precision = 6) {
+	static_assert(isFormattableNum<T>(), "njh::appendNum only for integer and floating point types");
+	char buffer[128];
+	auto res = impl::toCharsNum(buffer, buffer + sizeof(buffer), val, format, precision);
+	if (std::errc() == res.ec) {
+		out.append(buffer, res.ptr - buffer);
+		return;
+	}
+	//only very large fixed format numbers get here
+	std::string large(8192, '\0');
+	res = impl::toCharsNum(&large[0], &large[0] + large.size(), val, format, precision);
+	if (std::errc() == res.ec) {
+		out.append(large.data(), res.ptr - large.data());
+		return;
+	}
+	//e.g. a huge precision, let a stream size it rather than appending a buffer that was never written to
+	std::ostringstream stream;
+	stream.imbue(std::locale::classic());
+	switch (format) {
+	case FloatFormat::FIXED:
+		stream << std::fixed << std::setprecision(precision);
+		break;
+	case FloatFormat::SCIENTIFIC:
+		stream << std::scientific << std::setprecision(precision);
+		break;
+	case FloatFormat::SHORTEST:
+		stream << std::setprecision(std::numeric_limits<T>::max_digits10);
+		break;
+	case FloatFormat::GENERAL:
+	default:
+		stream << std::setprecision(precision);
+		break;
+	}
+	stream << val;
+	if (!stream) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error in formatting number with precision " << precision << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	out.append(stream.str());
+}
+
+/**@brief Convert a number to a string, see njh::appendNum
+ *
+ * @param val the number
+ * @param format how to write floating point numbers, ignored for integers
+ * @param precision the precision for floating point numbers
+ * @return the number as a string
+ */
+template<typename T>
+std::string numToStr(T val, FloatFormat format = FloatFormat::GENERAL, int precision = 6) {
+	std::string ret;
+	appendNum(ret, val, format, precision);
+	return ret;
+}
+
+}  // namespace njh
@@ -15,4 +15,6 @@
 #include "njhcpp/concurrency/LockableVec.hpp"
 #include "njhcpp/concurrency/concurrencyUtils.hpp"
 #include "njhcpp/concurrency/LockableJsonLog.hpp"
+#include "njhcpp/concurrency/MpscQueue.hpp"
+#include "njhcpp/concurrency/ShardedSet.hpp"
 
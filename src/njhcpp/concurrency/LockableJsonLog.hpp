@@ -10,20 +10,73 @@
 
 #include "njhcpp/jsonUtils.h"
 #include "njhcpp/IO.h"
+#include "njhcpp/concurrency/MpscQueue.hpp"
+#include "njhcpp/concurrency/ShardedSet.hpp"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <exception>
 
 
 namespace njh {
 
+/**@brief A log of json entries keyed by a unique id that can be added to from many threads
+ *
+ * By default the entries are kept in one Json::Value and written by writeLog(). In streaming mode (constructed with StreamingPars) the file
+ * is JSON Lines, one object per line: {"date": ...}, then {"<uid>": <entry>} per entry, then {"totalTime": ...} from writeLog(),
+ * so merging the lines gives the same object as the default mode. Entries are serialized on the calling thread and handed
+ * to a lock-free queue that a background thread writes out in batches, so memory stays small and a crash only loses the last batch.
+ *
+ */
 class LockableJsonLog {
 
 public:
 
+	/**@brief Settings for the streaming mode
+	 *
+	 */
+	struct StreamingPars {
+		std::chrono::milliseconds flushInterval_ { 1000 }; /**< the longest an entry waits before being flushed to disk */
+		size_t batchBytes_ = 1024 * 1024; /**< write out once this much is waiting, even before the flush interval */
+		std::chrono::milliseconds pollInterval_ { 5 }; /**< how long the writer sleeps when there's nothing queued */
+	};
+
 	LockableJsonLog(const bfs::path &logFnp, bool overWrite = true) :
 			logFileOpts_(logFnp) {
 		logFileOpts_.overWriteFile_ = overWrite;
 		log_["date"] = njh::json::toJson(njh::getCurrentDateFull());
 	}
 
+	/**@brief Construct in streaming (JSON Lines) mode, the file is opened and the date line written straight away
+	 *
+	 * @param logFnp the log file
+	 * @param overWrite whether to overwrite an existing file
+	 * @param pars the streaming settings
+	 */
+	LockableJsonLog(const bfs::path &logFnp, bool overWrite, const StreamingPars & pars) :
+			logFileOpts_(logFnp), streaming_(true), streamingPars_(pars) {
+		logFileOpts_.overWriteFile_ = overWrite;
+		logFileOpts_.openFile(streamOut_);
+		Json::Value dateLine;
+		dateLine["date"] = njh::json::toJson(njh::getCurrentDateFull());
+		streamOut_ << njh::json::writeAsOneLine(dateLine) << "\n";
+		streamOut_.flush();
+		writer_ = std::thread([this]() {
+			writeQueued();
+		});
+	}
+
+	~LockableJsonLog() {
+		if (writer_.joinable()) {
+			try {
+				stopWriter();
+			} catch (...) {
+				//nothing can be done about a failed write while being destroyed
+			}
+		}
+	}
+
 	Json::Value log_;
 	std::mutex logMut_;
 
@@ -32,6 +85,10 @@ public:
 	njh::stopWatch watch_;
 
 	void addToLog(const std::string &uid, const Json::Value &adding) {
+		if (streaming_) {
+			addToStream(uid, adding);
+			return;
+		}
 		std::lock_guard<std::mutex> lock(logMut_);
 		if (log_.isMember(uid)) {
 			std::stringstream ss;
@@ -42,7 +99,22 @@ public:
 		log_[uid] = adding;
 	}
 
+	/**@brief Write the log, in streaming mode this writes out what is queued, adds the totalTime line and closes the file,
+	 * so should only be called once all threads are done adding
+	 *
+	 */
 	void writeLog() {
+		if (streaming_) {
+			std::lock_guard<std::mutex> lock(logMut_);
+			if (writer_.joinable()) {
+				stopWriter();
+				Json::Value timeLine;
+				timeLine["totalTime"] = njh::json::toJson(watch_.totalTime());
+				streamOut_ << njh::json::writeAsOneLine(timeLine) << std::endl;
+				streamOut_.close();
+			}
+			return;
+		}
 		std::lock_guard<std::mutex> lock(logMut_);
 		std::ofstream outFile;
 		logFileOpts_.openFile(outFile);
@@ -50,8 +122,92 @@ public:
 		outFile << log_ << std::endl;
 		;
 	}
-};
 
-} /* namespace njhseq */
+	bool streaming() const {
+		return streaming_;
+	}
+
+private:
+	bool streaming_ = false; /**< whether in JSON Lines mode */
+	StreamingPars streamingPars_;
+	std::ofstream streamOut_; /**< the log file in streaming mode */
+	concurrent::MpscQueue<std::string> queued_; /**< serialized lines waiting to be written */
+	concurrent::ShardedSet<std::string> uids_; /**< the uids added in streaming mode */
+	std::thread writer_; /**< writes queued_ to streamOut_ */
+	std::atomic<bool> stopping_ { false };
+	std::exception_ptr writeError_; /**< set by the writer thread if writing fails */
+	std::atomic<bool> hasWriteError_ { false };
+
+	void addToStream(const std::string &uid, const Json::Value &adding) {
+		if (hasWriteError_) {
+			std::rethrow_exception(writeError_);
+		}
+		if (stopping_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error, can't add " << uid << ", log has already been written" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		if (!uids_.insert(uid)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error, log already has info for " << uid
+					<< "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		std::ostringstream line;
+		line << '{';
+		njh::json::writeAsOneLine(Json::Value(uid), line);
+		line << ':';
+		njh::json::writeAsOneLine(adding, line);
+		line << "}\n";
+		queued_.push(line.str());
+	}
+
+	void writeQueued() {
+		std::string batch;
+		std::string line;
+		auto lastFlush = std::chrono::steady_clock::now();
+		try {
+			while (true) {
+				//read stopping_ before draining so nothing pushed before the stop is missed
+				const bool stopping = stopping_;
+				while (batch.size() < streamingPars_.batchBytes_ && queued_.tryPop(line)) {
+					batch.append(line);
+				}
+				const auto now = std::chrono::steady_clock::now();
+				const bool flushDue = now - lastFlush >= streamingPars_.flushInterval_;
+				if (!batch.empty() && (batch.size() >= streamingPars_.batchBytes_ || flushDue || stopping)) {
+					streamOut_.write(batch.data(), batch.size());
+					batch.clear();
+				}
+				if (flushDue || stopping) {
+					streamOut_.flush();
+					lastFlush = now;
+					if (!streamOut_) {
+						std::stringstream ss;
+						ss << __PRETTY_FUNCTION__ << ", error in writing to " << logFileOpts_.outName() << "\n";
+						throw std::runtime_error { ss.str() };
+					}
+				}
+				if (stopping && batch.empty() && queued_.empty()) {
+					break;
+				}
+				if (queued_.empty()) {
+					std::this_thread::sleep_for(streamingPars_.pollInterval_);
+				}
+			}
+		} catch (...) {
+			writeError_ = std::current_exception();
+			hasWriteError_ = true;
+		}
+	}
 
+	void stopWriter() {
+		stopping_ = true;
+		writer_.join();
+		if (hasWriteError_) {
+			std::rethrow_exception(writeError_);
+		}
+	}
+};
 
+} /* namespace njhseq */
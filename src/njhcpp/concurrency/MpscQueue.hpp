@@ -0,0 +1,92 @@
+#pragma once
+/*
+ * MpscQueue.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <atomic>
+#include <utility>
+
+namespace njh {
+namespace concurrent {
+
+/**@brief An unbounded lock-free queue for many producer threads and one consumer thread (Vyukov's intrusive MPSC queue)
+ *
+ * push() is a single atomic exchange so producers never wait on each other or on the consumer, only one thread may call tryPop()
+ *
+ */
+template<typename T>
+class MpscQueue {
+public:
+	MpscQueue() :
+			head_(new Node()), tail_(head_.load()) {
+	}
+
+	~MpscQueue() {
+		Node * node = tail_;
+		while (nullptr != node) {
+			Node * next = node->next_.load(std::memory_order_relaxed);
+			delete node;
+			node = next;
+		}
+	}
+
+	MpscQueue(const MpscQueue &) = delete;
+	MpscQueue & operator=(const MpscQueue &) = delete;
+
+	/**@brief Add a value, safe to call from any number of threads
+	 *
+	 * @param val the value to add
+	 */
+	void push(T val) {
+		Node * node = new Node(std::move(val));
+		Node * prev = head_.exchange(node, std::memory_order_acq_rel);
+		prev->next_.store(node, std::memory_order_release);
+	}
+
+	/**@brief Take the oldest value, only call from the consumer thread
+	 *
+	 * A push that is part way done can make this return false even though the queue isn't quite empty, it will show up on a later call
+	 *
+	 * @param val set to the value taken
+	 * @return whether a value was taken
+	 */
+	bool tryPop(T & val) {
+		Node * next = tail_->next_.load(std::memory_order_acquire);
+		if (nullptr == next) {
+			return false;
+		}
+		val = std::move(next->val_);
+		delete tail_;
+		//next becomes the new stub, its value has been moved out
+		tail_ = next;
+		return true;
+	}
+
+	/**@brief Whether there is nothing to pop, only meaningful from the consumer thread
+	 *
+	 * @return true if empty
+	 */
+	bool empty() const {
+		return nullptr == tail_->next_.load(std::memory_order_acquire);
+	}
+
+private:
+	struct Node {
+		Node() = default;
+		explicit Node(T && val) :
+				val_(std::move(val)) {
+		}
+		T val_;
+		std::atomic<Node *> next_ { nullptr };
+	};
+
+	std::atomic<Node *> head_; /**< the last node pushed, producers swap themselves in here */
+	Node * tail_; /**< the stub before the oldest value, only touched by the consumer */
+};
+
+}  // namespace concurrent
+}  // namespace njh
@@ -0,0 +1,77 @@
+#pragma once
+/*
+ * ShardedSet.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <unordered_set>
+#include <mutex>
+#include <array>
+#include <functional>
+
+namespace njh {
+namespace concurrent {
+
+/**@brief A set safe for concurrent insertion, split over shards each with its own mutex so threads only contend when they hash to the same shard
+ *
+ */
+template<typename T, typename HASH = std::hash<T>, size_t NSHARDS = 64>
+class ShardedSet {
+public:
+	/**@brief Insert a value
+	 *
+	 * @param val the value
+	 * @return true if the value wasn't in the set already
+	 */
+	bool insert(const T & val) {
+		Shard & shard = shardFor(val);
+		std::lock_guard<std::mutex> lock(shard.mut_);
+		return shard.vals_.emplace(val).second;
+	}
+
+	/**@brief Check for a value
+	 *
+	 * @param val the value
+	 * @return true if the value is in the set
+	 */
+	bool contains(const T & val) {
+		Shard & shard = shardFor(val);
+		std::lock_guard<std::mutex> lock(shard.mut_);
+		return shard.vals_.end() != shard.vals_.find(val);
+	}
+
+	/**@brief The number of values, locks every shard in turn so is only exact when nothing is inserting
+	 *
+	 * @return the number of values
+	 */
+	size_t size() {
+		size_t ret = 0;
+		for (auto & shard : shards_) {
+			std::lock_guard<std::mutex> lock(shard.mut_);
+			ret += shard.vals_.size();
+		}
+		return ret;
+	}
+
+private:
+	struct Shard {
+		std::mutex mut_;
+		std::unordered_set<T, HASH> vals_;
+	};
+	std::array<Shard, NSHARDS> shards_;
+
+	Shard & shardFor(const T & val) {
+		//mix the hash so hashes that only differ in high bits still spread
+		size_t hash = HASH()(val);
+		hash ^= hash >> 29;
+		hash *= 0xBF58476D1CE4E5B9ULL;
+		hash ^= hash >> 32;
+		return shards_[hash % NSHARDS];
+	}
+};
+
+}  // namespace concurrent
+}  // namespace njh
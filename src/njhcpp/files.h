@@ -6,6 +6,7 @@
 #include "njhcpp/files/fileSystemUtils.hpp"
 #include "njhcpp/files/fileUtilities.hpp"
 #include "njhcpp/files/podVecIO.hpp"
+#include "njhcpp/files/ColumnarTable.hpp"
 #include "njhcpp/files/fileObjects.h"
 
 
@@ -0,0 +1,508 @@
+#pragma once
+/*
+ * ColumnarTable.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+
+#include "njhcpp/IO.h"
+#include "njhcpp/utils/StrViewTokenizer.hpp"
+#include "njhcpp/utils/numParsing.hpp"
+#include "njhcpp/concurrency/concurrencyUtils.hpp"
+
+namespace njh {
+namespace files {
+namespace bfs = boost::filesystem;
+
+/**@brief Class to hold parameters for reading a delimited table with njh::files::ColumnarTable
+ *
+ */
+class ColumnarTableReadPars {
+public:
+	/**@brief The type to store a column as
+	 *
+	 */
+	enum class ColType {
+		INT, /**< stored as int64_t */
+		DOUBLE, /**< stored as double */
+		STR /**< stored as a std::string_view into the table's buffer */
+	};
+
+	ColumnarTableReadPars() = default;
+
+	/**@brief Construct with the delimiter
+	 *
+	 * @param delim the delimiter, "whitespace" splits on runs of whitespace like tokenizeString()
+	 */
+	explicit ColumnarTableReadPars(const std::string & delim) :
+			delim_(delim) {
+	}
+
+	std::string delim_ = "\t"; /**< the delimiter between columns, "whitespace" to split on runs of whitespace */
+	bool hasHeader_ = true; /**< whether the first line is the column names */
+	bool inferRowNames_ = true; /**< if the header has one fewer field than the rows take the first column as row names like njh::files::hasPossibleRowNames() */
+	bool hasRowNames_ = false; /**< the first column is row names, only used if inferRowNames_ is false */
+	std::vector<std::string> columns_; /**< only read these columns (in this order), empty reads all of them, unused columns aren't parsed */
+	std::unordered_map<std::string, ColType> colTypes_; /**< set the type of columns by name, other columns are inferred */
+	uint32_t typeInferenceLines_ = 100; /**< the number of rows to look at when inferring column types */
+	bool strictTypes_ = false; /**< throw if a value doesn't fit the inferred type rather than falling back to a wider type (int -> double -> string) */
+	uint32_t numThreads_ = 1; /**< the number of threads to parse with */
+	uint32_t chunksPerThread_ = 4; /**< how many newline aligned chunks to split the input into per thread */
+};
+
+/**@brief A delimited table (tsv, csv etc, no quoting) stored by column with typed columns, read with multiple threads
+ *
+ * The whole input is read into one buffer, string columns and row names are std::string_views into that buffer so they are only valid as long as the table is.
+ * Empty lines and a trailing \r on each line are ignored.
+ *
+ */
+class ColumnarTable {
+public:
+	using ColType = ColumnarTableReadPars::ColType;
+
+	/**@brief A column of the table, only the vector for the column's type is filled
+	 *
+	 */
+	class Column {
+	public:
+		std::string name_; /**< the column name */
+		ColType type_ = ColType::STR; /**< the type of the column */
+		std::vector<int64_t> ints_; /**< the values for ColType::INT */
+		std::vector<double> doubles_; /**< the values for ColType::DOUBLE */
+		std::vector<std::string_view> strs_; /**< the values for ColType::STR */
+
+		size_t size() const {
+			switch (type_) {
+			case ColType::INT:
+				return ints_.size();
+			case ColType::DOUBLE:
+				return doubles_.size();
+			case ColType::STR:
+			default:
+				return strs_.size();
+			}
+		}
+	};
+
+	/**@brief Read a table, plain, gzipped (by .gz extension) or STDIN
+	 *
+	 * @param inOpts the input to read
+	 * @param pars the reading parameters
+	 */
+	ColumnarTable(const InOptions & inOpts, const ColumnarTableReadPars & pars) :
+			buffer_(std::make_unique<std::string>()) {
+		readInput(inOpts);
+		parse(pars);
+	}
+
+	/**@brief Read a table from a file
+	 *
+	 * @param fnp the file to read
+	 * @param pars the reading parameters
+	 */
+	ColumnarTable(const bfs::path & fnp, const ColumnarTableReadPars & pars) :
+			ColumnarTable(InOptions(fnp), pars) {
+	}
+
+	std::vector<std::string_view> rowNames_; /**< the row names if the table has them */
+	std::vector<Column> columns_; /**< the columns read in */
+
+	size_t nRows() const {
+		return nRows_;
+	}
+
+	size_t nCols() const {
+		return columns_.size();
+	}
+
+	bool hasRowNames() const {
+		return hasRowNames_;
+	}
+
+	std::vector<std::string> colNames() const {
+		std::vector<std::string> ret;
+		for (const auto & col : columns_) {
+			ret.emplace_back(col.name_);
+		}
+		return ret;
+	}
+
+	bool hasColumn(const std::string & name) const {
+		return columns_.end() != std::find_if(columns_.begin(), columns_.end(),
+				[&name](const Column & col) {return col.name_ == name;});
+	}
+
+	/**@brief Get a column by name, throws if it wasn't read
+	 *
+	 * @param name the column name
+	 * @return the column
+	 */
+	const Column & getColumn(const std::string & name) const {
+		for (const auto & col : columns_) {
+			if (col.name_ == name) {
+				return col;
+			}
+		}
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error no column named " << name
+				<< ", options are: " << njh::conToStr(colNames(), ", ") << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+
+private:
+	std::unique_ptr<std::string> buffer_; /**< the whole input, string columns and row names point into this so it's on the heap to survive moves */
+	size_t nRows_ = 0;
+	bool hasRowNames_ = false;
+
+	/**@brief A newline aligned piece of the input
+	 *
+	 */
+	struct Chunk {
+		const char * begin_ = nullptr;
+		const char * end_ = nullptr;
+		size_t rowStart_ = 0; /**< the row index of the first line in the chunk */
+		size_t nRows_ = 0; /**< the number of non-empty lines in the chunk */
+	};
+
+	/**@brief Get the next line in [pos, end) without the newline or a trailing \r, advancing pos past the newline
+	 *
+	 */
+	static std::string_view nextLine(const char *& pos, const char * end) {
+		const char * lineEnd = simd::findChar(pos, end, '\n');
+		std::string_view line(pos, lineEnd - pos);
+		pos = end == lineEnd ? end : lineEnd + 1;
+		if (!line.empty() && '\r' == line.back()) {
+			line.remove_suffix(1);
+		}
+		return line;
+	}
+
+	void readInput(const InOptions & inOpts) {
+		InputStream in(inOpts);
+		if ("" != inOpts.inFilename_ && "STDIN" != inOpts.inFilename_
+				&& !njh::endsWith(inOpts.inFilename_.string(), ".gz")) {
+			buffer_->reserve(bfs::file_size(inOpts.inFilename_));
+		}
+		const size_t blockSize = 1024 * 1024;
+		std::unique_ptr<char[]> block = std::make_unique<char[]>(blockSize);
+		while (in.read(block.get(), blockSize) || in.gcount() > 0) {
+			buffer_->append(block.get(), in.gcount());
+		}
+	}
+
+	static ColType classifyToken(std::string_view tok) {
+		int64_t intVal = 0;
+		if (NumParseStatus::OK == tryParseNum(tok, intVal)) {
+			return ColType::INT;
+		}
+		double doubleVal = 0;
+		if (NumParseStatus::OK == tryParseNum(tok, doubleVal)) {
+			return ColType::DOUBLE;
+		}
+		return ColType::STR;
+	}
+
+	/**@brief Parse the lines of a chunk into the columns, fieldToCol maps the fields of a line to the column index to store in (-1 to skip)
+	 *
+	 * @param needed set to the wider type a column needs when a value doesn't fit its current type, that column isn't stored for the rest of the chunk
+	 */
+	void parseChunk(const Chunk & chunk, const ColumnarTableReadPars & pars,
+			const std::vector<int32_t> & fieldToCol, size_t expectedFields,
+			bool firstPass, std::vector<ColType> & needed) {
+		std::vector<bool> failed(columns_.size(), false);
+		const char * pos = chunk.begin_;
+		size_t row = chunk.rowStart_;
+		while (pos < chunk.end_) {
+			const std::string_view line = nextLine(pos, chunk.end_);
+			if (line.empty()) {
+				continue;
+			}
+			StrViewTokenizer toks(line, pars.delim_);
+			std::string_view tok;
+			size_t field = 0;
+			while (field < fieldToCol.size() && toks.next(tok)) {
+				if (firstPass && hasRowNames_ && 0 == field) {
+					rowNames_[row] = tok;
+				}
+				const int32_t colPos = fieldToCol[field];
+				++field;
+				if (colPos < 0) {
+					continue;
+				}
+				auto & col = columns_[colPos];
+				if (failed[colPos]) {
+					needed[colPos] = std::max(needed[colPos], classifyToken(tok));
+					continue;
+				}
+				NumParseStatus status = NumParseStatus::OK;
+				switch (col.type_) {
+				case ColType::INT:
+					status = tryParseNum(tok, col.ints_[row]);
+					break;
+				case ColType::DOUBLE:
+					status = tryParseNum(tok, col.doubles_[row]);
+					break;
+				case ColType::STR:
+					col.strs_[row] = tok;
+					break;
+				}
+				if (NumParseStatus::OK != status) {
+					if (pars.strictTypes_ || njh::in(col.name_, pars.colTypes_)) {
+						throw bad_num_parse(tok, ColType::INT == col.type_ ? "int64_t" : "double", status, row);
+					}
+					failed[colPos] = true;
+					needed[colPos] = std::max(needed[colPos], classifyToken(tok));
+				}
+			}
+			//projected reads stop at the last needed field so the length of the rest of the line isn't checked
+			if (firstPass && (field < fieldToCol.size() || (fieldToCol.size() == expectedFields && toks.next(tok)))) {
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error in data row " << row
+						<< ", expected " << expectedFields << " fields but found "
+						<< field + (field < fieldToCol.size() ? 0 : 1 + toks.count()) << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+			++row;
+		}
+	}
+
+	/**@brief Run func over the chunks with pars.numThreads_ threads, rethrowing the first exception thrown
+	 *
+	 */
+	template<typename FUNC>
+	static void runOverChunks(const std::vector<Chunk> & chunks, uint32_t numThreads, FUNC func) {
+		std::atomic<size_t> nextChunk { 0 };
+		std::vector<std::exception_ptr> errors(chunks.size());
+		std::function<void()> worker = [&]() {
+			size_t chunkPos = nextChunk++;
+			while (chunkPos < chunks.size()) {
+				try {
+					func(chunkPos);
+				} catch (...) {
+					errors[chunkPos] = std::current_exception();
+				}
+				chunkPos = nextChunk++;
+			}
+		};
+		concurrent::runVoidFunctionThreaded(worker, std::max<uint32_t>(1, std::min<size_t>(numThreads, chunks.size())));
+		for (const auto & error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	void parse(const ColumnarTableReadPars & pars) {
+		const char * pos = buffer_->data();
+		const char * const end = buffer_->data() + buffer_->size();
+		//header and first data line
+		std::vector<std::string> header;
+		if (pars.hasHeader_) {
+			std::string_view headerLine;
+			while (pos < end && headerLine.empty()) {
+				headerLine = nextLine(pos, end);
+			}
+			for (const auto & tok : StrViewTokenizer(headerLine, pars.delim_)) {
+				header.emplace_back(tok);
+			}
+		}
+		const char * const dataStart = pos;
+		size_t expectedFields = 0;
+		{
+			const char * samplePos = dataStart;
+			std::string_view firstLine;
+			while (samplePos < end && firstLine.empty()) {
+				firstLine = nextLine(samplePos, end);
+			}
+			expectedFields = StrViewTokenizer(firstLine, pars.delim_).count();
+		}
+		if (0 == expectedFields) {
+			expectedFields = header.size();
+		}
+		//row names
+		if (pars.inferRowNames_) {
+			hasRowNames_ = pars.hasHeader_ && 0 != expectedFields && header.size() + 1 == expectedFields;
+		} else {
+			hasRowNames_ = pars.hasRowNames_;
+		}
+		const size_t nDataFields = expectedFields - (hasRowNames_ && expectedFields > 0 ? 1 : 0);
+		if (pars.hasHeader_) {
+			if (hasRowNames_ && header.size() == expectedFields && !header.empty()) {
+				//header has a name for the row names column
+				header.erase(header.begin());
+			}
+			if (header.size() != nDataFields) {
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error header has " << header.size()
+						<< " fields but the first row has " << expectedFields << " fields"
+						<< (hasRowNames_ ? " with row names" : "") << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+		} else {
+			for (size_t col = 0; col < nDataFields; ++col) {
+				header.emplace_back("col" + estd::to_string(col));
+			}
+		}
+		//projection
+		const size_t fieldOffset = hasRowNames_ ? 1 : 0;
+		std::vector<int32_t> fieldToCol(expectedFields, -1);
+		std::vector<size_t> colToField;
+		if (pars.columns_.empty()) {
+			for (size_t col = 0; col < header.size(); ++col) {
+				colToField.emplace_back(col + fieldOffset);
+			}
+		} else {
+			for (const auto & name : pars.columns_) {
+				auto found = std::find(header.begin(), header.end(), name);
+				if (header.end() == found) {
+					std::stringstream ss;
+					ss << __PRETTY_FUNCTION__ << ", error no column named " << name
+							<< ", options are: " << njh::conToStr(header, ", ") << "\n";
+					throw std::runtime_error { ss.str() };
+				}
+				colToField.emplace_back(std::distance(header.begin(), found) + fieldOffset);
+			}
+		}
+		columns_.resize(colToField.size());
+		for (size_t col = 0; col < colToField.size(); ++col) {
+			columns_[col].name_ = header[colToField[col] - fieldOffset];
+			fieldToCol[colToField[col]] = col;
+		}
+		//don't tokenize past the last field that's needed (the row names are always needed)
+		size_t lastField = hasRowNames_ ? 1 : 0;
+		for (const auto field : colToField) {
+			lastField = std::max(lastField, field + 1);
+		}
+		if (!pars.columns_.empty()) {
+			fieldToCol.resize(lastField);
+		}
+		//type inference from the first rows
+		{
+			std::vector<bool> inferred(columns_.size(), false);
+			for (auto & col : columns_) {
+				auto setType = pars.colTypes_.find(col.name_);
+				col.type_ = pars.colTypes_.end() == setType ? ColType::INT : setType->second;
+			}
+			const char * samplePos = dataStart;
+			uint32_t sampled = 0;
+			while (samplePos < end && sampled < pars.typeInferenceLines_) {
+				const std::string_view line = nextLine(samplePos, end);
+				if (line.empty()) {
+					continue;
+				}
+				++sampled;
+				size_t field = 0;
+				for (const auto & tok : StrViewTokenizer(line, pars.delim_)) {
+					if (field >= fieldToCol.size()) {
+						break;
+					}
+					const int32_t colPos = fieldToCol[field];
+					++field;
+					if (colPos >= 0 && !njh::in(columns_[colPos].name_, pars.colTypes_)) {
+						columns_[colPos].type_ = std::max(columns_[colPos].type_, classifyToken(tok));
+					}
+				}
+			}
+		}
+		//newline aligned chunks
+		const size_t nChunks = std::max<size_t>(1, static_cast<size_t>(pars.numThreads_) * pars.chunksPerThread_);
+		const size_t dataSize = end - dataStart;
+		std::vector<Chunk> chunks;
+		const char * chunkStart = dataStart;
+		for (size_t chunkNum = 1; chunkNum <= nChunks && chunkStart < end; ++chunkNum) {
+			const char * chunkEnd = chunkNum == nChunks ? end : dataStart + dataSize / nChunks * chunkNum;
+			if (chunkEnd < chunkStart) {
+				chunkEnd = chunkStart;
+			}
+			chunkEnd = simd::findChar(chunkEnd, end, '\n');
+			if (end != chunkEnd) {
+				++chunkEnd;
+			}
+			Chunk chunk;
+			chunk.begin_ = chunkStart;
+			chunk.end_ = chunkEnd;
+			chunks.emplace_back(chunk);
+			chunkStart = chunkEnd;
+		}
+		//count the rows of each chunk so each thread can write straight into its rows
+		runOverChunks(chunks, pars.numThreads_, [&chunks](size_t chunkPos) {
+			auto & chunk = chunks[chunkPos];
+			const char * linePos = chunk.begin_;
+			while (linePos < chunk.end_) {
+				if (!nextLine(linePos, chunk.end_).empty()) {
+					++chunk.nRows_;
+				}
+			}
+		});
+		for (auto & chunk : chunks) {
+			chunk.rowStart_ = nRows_;
+			nRows_ += chunk.nRows_;
+		}
+		auto allocate = [this](Column & col) {
+			col.ints_.clear();
+			col.doubles_.clear();
+			col.strs_.clear();
+			switch (col.type_) {
+			case ColType::INT:
+				col.ints_.resize(nRows_);
+				break;
+			case ColType::DOUBLE:
+				col.doubles_.resize(nRows_);
+				break;
+			case ColType::STR:
+				col.strs_.resize(nRows_);
+				break;
+			}
+		};
+		for (auto & col : columns_) {
+			allocate(col);
+		}
+		if (hasRowNames_) {
+			rowNames_.resize(nRows_);
+		}
+		std::vector<std::vector<ColType>> chunkNeeded(chunks.size(), std::vector<ColType>(columns_.size(), ColType::INT));
+		runOverChunks(chunks, pars.numThreads_, [&](size_t chunkPos) {
+			parseChunk(chunks[chunkPos], pars, fieldToCol, expectedFields, true, chunkNeeded[chunkPos]);
+		});
+		//values after the type inference rows that didn't fit, widen those columns and parse just them again
+		std::vector<int32_t> redoFieldToCol(fieldToCol.size(), -1);
+		bool redo = false;
+		for (size_t col = 0; col < columns_.size(); ++col) {
+			ColType widest = columns_[col].type_;
+			for (const auto & needed : chunkNeeded) {
+				widest = std::max(widest, needed[col]);
+			}
+			if (widest != columns_[col].type_) {
+				columns_[col].type_ = widest;
+				allocate(columns_[col]);
+				redoFieldToCol[colToField[col]] = col;
+				redo = true;
+			}
+		}
+		if (redo) {
+			//trim off the fields after the last one being redone
+			while (!redoFieldToCol.empty() && redoFieldToCol.back() < 0) {
+				redoFieldToCol.pop_back();
+			}
+			std::vector<std::vector<ColType>> redoNeeded(chunks.size(), std::vector<ColType>(columns_.size(), ColType::INT));
+			runOverChunks(chunks, pars.numThreads_, [&](size_t chunkPos) {
+				parseChunk(chunks[chunkPos], pars, redoFieldToCol, expectedFields, false, redoNeeded[chunkPos]);
+			});
+		}
+	}
+};
+
+}  // namespace files
+}  // namespace njh
@@ -13,6 +13,7 @@
 #include "njhcpp/utils/stringUtils.hpp" //appendAsNeededRet()
 #include "njhcpp/files/fileSystemUtils.hpp"
 #include "njhcpp/IO.h"
+#include "njhcpp/simulation/ReservoirSampler.hpp"
 
 
 namespace njh {
@@ -194,6 +195,48 @@ inline std::vector<std::string> getAllLines(const bfs::path & fnp){
 
 
 
+/**@brief Get a uniform random sample of the lines of a file or input in one pass without holding the whole thing in memory
+ *
+ * @param inOpts the input to read
+ * @param sampleSize the number of lines to sample
+ * @param seed the seed for the sampling so it can be repeated
+ * @return the sampled lines in the order they appear in the input, all lines if there are fewer than sampleSize
+ */
+inline std::vector<std::string> sampleLines(const InOptions & inOpts, uint64_t sampleSize, uint64_t seed){
+	ReservoirSampler<std::pair<uint64_t, std::string>> sampler(sampleSize, seed);
+	std::pair<uint64_t, std::string> current{0, ""};
+	InputStream textFile(inOpts);
+	while(crossPlatGetline(textFile, current.second)){
+		if(sampler.keepsNext()){
+			sampler.add(std::move(current));
+		}else{
+			sampler.skip();
+		}
+		++current.first;
+	}
+	auto sample = sampler.release();
+	std::sort(sample.begin(), sample.end(),
+			[](const std::pair<uint64_t, std::string> & p1, const std::pair<uint64_t, std::string> & p2){
+		return p1.first < p2.first;
+	});
+	std::vector<std::string> ret;
+	ret.reserve(sample.size());
+	for(auto & line : sample){
+		ret.emplace_back(std::move(line.second));
+	}
+	return ret;
+}
+
+/**@brief Get a uniform random sample of the lines of a file or input in one pass, seeded from std::random_device
+ *
+ * @param inOpts the input to read
+ * @param sampleSize the number of lines to sample
+ * @return the sampled lines in the order they appear in the input, all lines if there are fewer than sampleSize
+ */
+inline std::vector<std::string> sampleLines(const InOptions & inOpts, uint64_t sampleSize){
+	return sampleLines(inOpts, sampleSize, std::random_device()());
+}
+
 /**@brief Get files by pattern in the current directory or but reading a file or input
  *
  * @param directory the driectory to search
@@ -217,6 +260,29 @@ inline std::vector<bfs::path> gatherFilesByPatOrNames(const bfs::path & director
 	return ret;
 }
 
+/**@brief Get files by a compiled njh::PatternSet in the directory or but reading a file or input
+ *
+ * @param directory the driectory to search
+ * @param filter the compiled patterns the file names are checked against
+ * @param fileNames either a file name where each line is a file or is comma separated filenames
+ * @return a vector of paths
+ */
+inline std::vector<bfs::path> gatherFilesByPatOrNames(const bfs::path & directory, const PatternSet & filter,
+		const std::string & fileNames = "") {
+	std::vector<bfs::path> ret;
+	if ("" != fileNames) {
+		if (bfs::basename(fileNames).length() < 255 && bfs::exists(fileNames)) {
+			ret = vecStrToPaths(getAllLines(fileNames));
+		} else {
+			ret = vecStrToPaths(tokenizeString(fileNames, ","));
+		}
+	} else {
+		auto inFiles = listAllFiles(directory, false, filter);
+		ret = getVecOfMapKeys(inFiles);
+	}
+	return ret;
+}
+
 /**@brief Get files by pattern in the current directory or but reading a file or input
  *
  * @param patReg regex pattern
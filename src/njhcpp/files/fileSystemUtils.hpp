@@ -14,6 +14,7 @@
 #include <sys/stat.h> //chmod
 #include <boost/filesystem.hpp>
 #include "njhcpp/utils/stringUtils.hpp" //appendAsNeededRet()
+#include "njhcpp/utils/PatternSet.hpp"
 #include "njhcpp/utils/time/timeUtils.hpp" //getCurrentDate()
 #include "njhcpp/files/filePathUtils.hpp" //join()
 #include "njhcpp/files/fileUtilities.hpp"
@@ -143,9 +144,36 @@ inline std::map<bfs::path, bool> listAllFiles(const bfs::path & dirName,
 	listAllFilesHelper(dirName, recursive, filesGathering, 1, levels);
 	std::map<bfs::path, bool> files = convertMapFnpFnpToFnpIsDir(filesGathering);
 	if (!contains.empty()) {
+		PatternSet filter(contains, std::vector<std::string>{});
 		std::map<bfs::path, bool> specificFiles;
 		for (const auto & f : files) {
-			if (checkForSubStrs(f.first.filename().string(), contains)) {
+			if (filter.matches(f.first.filename().string())) {
+				specificFiles.emplace(f);
+			}
+		}
+		return specificFiles;
+	}
+	return files;
+}
+
+/**@brief List files in a directory with optional recursive search and filtering the file names with a compiled njh::PatternSet
+ *
+ * @param dirName The directory to search
+ * @param recursive Whether the search should be recursive
+ * @param filter The compiled include/exclude substrings and regex patterns the file path name is checked against
+ * @param levels The maximum number of levels to search (1 being the first directory)
+ * @return A map of boost::filesystem paths with the value being a bool with true indicating it's a directory
+ */
+inline std::map<bfs::path, bool> listAllFiles(const bfs::path & dirName,
+		bool recursive, const PatternSet & filter, uint32_t levels =
+				std::numeric_limits<uint32_t>::max()) {
+	std::map<bfs::path, bfs::path> filesGathering;
+	listAllFilesHelper(dirName, recursive, filesGathering, 1, levels);
+	std::map<bfs::path, bool> files = convertMapFnpFnpToFnpIsDir(filesGathering);
+	if (!filter.empty()) {
+		std::map<bfs::path, bool> specificFiles;
+		for (const auto & f : files) {
+			if (filter.matches(f.first.filename().string())) {
 				specificFiles.emplace(f);
 			}
 		}
@@ -487,7 +515,7 @@ inline bfs::path makeDirP(const bfs::path &parentDirectory,
 inline std::vector<bfs::path> gatherFiles(const bfs::path & dir,
 		const std::string & ext, bool recursive = false) {
 	auto files = listAllFiles(dir.string(), recursive,
-			{ std::regex { ".*" + ext + "$" } });
+			PatternSet(std::vector<std::string>{}, std::vector<std::string>{}, { ".*" + ext + "$" }));
 	std::vector<bfs::path> ret;
 	for (const auto & f : files) {
 		//add only files
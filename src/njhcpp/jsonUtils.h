@@ -3,3 +3,5 @@
 
 #include "njhcpp/jsonUtils/jsonUtils.hpp"
 #include "njhcpp/jsonUtils/MemberChecker.hpp"
+#include "njhcpp/jsonUtils/JsonWriter.hpp"
+#include "njhcpp/jsonUtils/JsonParsing.hpp"
@@ -0,0 +1,491 @@
+#pragma once
+/*
+ * JsonParsing.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+/**@file The parsing backends behind json::parse(), json::parseFile() and json::parseStream()
+ *
+ * By default jsoncpp does the parsing. Defining NJHCPP_USE_SIMDJSON (and linking -lsimdjson) parses with simdjson instead
+ * and builds the Json::Value from its tape, input simdjson rejects (comments, integers too big for 64 bits) is handed to jsoncpp
+ * so what parses and the error messages stay the same as before. Files are memory mapped rather than read through a stream.
+ *
+ */
+
+#include <json/json.h>
+#include <string>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(NJHCPP_USE_SIMDJSON)
+#include <simdjson.h>
+#endif
+
+namespace njh {
+namespace json {
+namespace impl {
+
+/**@brief A read only view of a whole file, memory mapped when possible and otherwise read into memory
+ *
+ */
+class MappedFile {
+public:
+	explicit MappedFile(const std::string & filename) {
+		int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in opening " << filename << ": " << std::strerror(errno) << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		struct stat info;
+		if (0 == ::fstat(fd, &info) && S_ISREG(info.st_mode) && info.st_size > 0) {
+			void * mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (MAP_FAILED != mapped) {
+				mapped_ = mapped;
+				size_ = info.st_size;
+				//the rest of the last page is readable and zero filled
+				const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+				capacity_ = (size_ + pageSize - 1) / pageSize * pageSize;
+				::madvise(mapped_, size_, MADV_SEQUENTIAL);
+			}
+		}
+		::close(fd);
+		if (nullptr == mapped_) {
+			//empty files, pipes and anything else that can't be mapped
+			std::ifstream inFile(filename, std::ios::binary);
+			buffer_.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+			size_ = buffer_.size();
+			capacity_ = buffer_.capacity();
+		}
+	}
+
+	~MappedFile() {
+		if (nullptr != mapped_) {
+			::munmap(mapped_, size_);
+		}
+	}
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator=(const MappedFile &) = delete;
+
+	const char * data() const {
+		return nullptr != mapped_ ? static_cast<const char *>(mapped_) : buffer_.data();
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	/**@brief How many bytes past data() can be read, at least size()
+	 *
+	 */
+	size_t capacity() const {
+		return capacity_;
+	}
+
+	std::string_view view() const {
+		return std::string_view(data(), size_);
+	}
+
+private:
+	void * mapped_ = nullptr;
+	std::string buffer_;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+};
+
+/**@brief The start of some json text for error messages, so a failed parse of a large input doesn't copy all of it
+ *
+ * @param text the json text
+ * @param maxLen the most characters to include
+ * @return the start of text, noting how much was left off
+ */
+inline std::string jsonSnippet(std::string_view text, size_t maxLen = 256) {
+	if (text.size() <= maxLen) {
+		return std::string(text);
+	}
+	return std::string(text.substr(0, maxLen)) + "... (" + std::to_string(text.size() - maxLen) + " more characters)";
+}
+
+/**@brief Parse with jsoncpp, using one reader per thread
+ *
+ * @param text the json text
+ * @param root set to the parsed value
+ * @param errs set to jsoncpp's error messages on failure
+ * @return whether parsing succeeded
+ */
+inline bool parseJsoncpp(std::string_view text, Json::Value & root, std::string & errs) {
+	thread_local std::unique_ptr<Json::CharReader> reader = []() {
+		Json::CharReaderBuilder readerBuilder;
+		return std::unique_ptr<Json::CharReader>(readerBuilder.newCharReader());
+	}();
+	return reader->parse(text.data(), text.data() + text.size(), &root, &errs);
+}
+
+#if defined(NJHCPP_USE_SIMDJSON)
+
+/**@brief Build a Json::Value from a parsed simdjson element
+ *
+ * @param element the element
+ * @param out set to the same value
+ */
+inline void simdjsonToValue(simdjson::dom::element element, Json::Value & out) {
+	switch (element.type()) {
+	case simdjson::dom::element_type::OBJECT: {
+		out = Json::Value(Json::objectValue);
+		for (auto field : simdjson::dom::object(element)) {
+			simdjsonToValue(field.value, out[std::string(field.key)]);
+		}
+		break;
+	}
+	case simdjson::dom::element_type::ARRAY: {
+		out = Json::Value(Json::arrayValue);
+		Json::ArrayIndex pos = 0;
+		for (auto child : simdjson::dom::array(element)) {
+			simdjsonToValue(child, out[pos++]);
+		}
+		break;
+	}
+	case simdjson::dom::element_type::STRING: {
+		std::string_view str = element.get_string().value_unsafe();
+		out = Json::Value(str.data(), str.data() + str.size());
+		break;
+	}
+	case simdjson::dom::element_type::INT64:
+		out = Json::Value(Json::Int64(element.get_int64().value_unsafe()));
+		break;
+	case simdjson::dom::element_type::UINT64:
+		out = Json::Value(Json::UInt64(element.get_uint64().value_unsafe()));
+		break;
+	case simdjson::dom::element_type::DOUBLE:
+		out = Json::Value(element.get_double().value_unsafe());
+		break;
+	case simdjson::dom::element_type::BOOL:
+		out = Json::Value(element.get_bool().value_unsafe());
+		break;
+	case simdjson::dom::element_type::NULL_VALUE:
+		out = Json::Value(Json::nullValue);
+		break;
+	}
+}
+
+/**@brief Parse with simdjson, using one parser per thread so its buffers are reused between calls
+ *
+ * @param text the json text
+ * @param capacity how many bytes past text.data() are readable, if there's simdjson's padding past the end the text isn't copied
+ * @param root set to the parsed value
+ * @return whether parsing succeeded
+ */
+inline bool parseSimdjson(std::string_view text, size_t capacity, Json::Value & root) {
+	thread_local simdjson::dom::parser parser;
+	const bool needsCopy = capacity < text.size() + simdjson::SIMDJSON_PADDING;
+	simdjson::dom::element element;
+	if (simdjson::SUCCESS != parser.parse(text.data(), text.size(), needsCopy).get(element)) {
+		return false;
+	}
+	simdjsonToValue(element, root);
+	return true;
+}
+
+#endif
+
+/**@brief Parse json text with the build's backend
+ *
+ * @param text the json text
+ * @param capacity how many bytes past text.data() are readable
+ * @param root set to the parsed value
+ * @param errs set to the error messages on failure
+ * @return whether parsing succeeded
+ */
+inline bool parseText(std::string_view text, size_t capacity, Json::Value & root, std::string & errs) {
+#if defined(NJHCPP_USE_SIMDJSON)
+	if (parseSimdjson(text, capacity, root)) {
+		return true;
+	}
+	//jsoncpp accepts a little more (comments, huge integers) and gives the error messages
+	root = Json::Value();
+#endif
+	(void) capacity;
+	return parseJsoncpp(text, root, errs);
+}
+
+}  // namespace impl
+
+/**@brief A parsed json document for pulling out a few fields by json pointer (RFC 6901, e.g. "/samples/0/name")
+ *
+ * With NJHCPP_USE_SIMDJSON this is simdjson's on demand parser over the file, only the parts asked for are parsed and turned
+ * into Json::Value so pulling a handful of fields out of a large file doesn't pay for building the whole tree.
+ * Otherwise the whole document is parsed into a Json::Value up front and the fields are looked up in it.
+ *
+ */
+class JsonDocument {
+public:
+	/**@brief Load a json file
+	 *
+	 * @param filename the file
+	 * @return the document
+	 */
+	static JsonDocument fromFile(const std::string & filename) {
+		JsonDocument ret;
+#if defined(NJHCPP_USE_SIMDJSON)
+		if (simdjson::SUCCESS != simdjson::padded_string::load(filename).get(ret.state_->text_)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in reading " << filename << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		ret.startDocument();
+#else
+		impl::MappedFile file(filename);
+		ret.parseRoot(file.view(), filename);
+#endif
+		return ret;
+	}
+
+	/**@brief Load json text
+	 *
+	 * @param text the json text, copied
+	 * @return the document
+	 */
+	static JsonDocument fromString(std::string_view text) {
+		JsonDocument ret;
+#if defined(NJHCPP_USE_SIMDJSON)
+		ret.state_->text_ = simdjson::padded_string(text);
+		ret.startDocument();
+#else
+		ret.parseRoot(text, "json text");
+#endif
+		return ret;
+	}
+
+	/**@brief Check for a value
+	 *
+	 * @param pointer the json pointer, "" for the whole document
+	 * @return whether there is a value at pointer
+	 */
+	bool has(std::string_view pointer) {
+#if defined(NJHCPP_USE_SIMDJSON)
+		simdjson::ondemand::value val;
+		return simdjson::SUCCESS == state_->doc_.at_pointer(pointer).get(val);
+#else
+		return nullptr != find(pointer);
+#endif
+	}
+
+	/**@brief Get a value, throws if there isn't one
+	 *
+	 * @param pointer the json pointer, "" for the whole document
+	 * @return the value at pointer
+	 */
+	Json::Value get(std::string_view pointer) {
+#if defined(NJHCPP_USE_SIMDJSON)
+		Json::Value ret;
+		simdjson::ondemand::value val;
+		simdjson::error_code error = simdjson::SUCCESS;
+		if (pointer.empty()) {
+			//at_pointer() rewinds on its own but reading the whole document doesn't
+			state_->doc_.rewind();
+			error = toValue(state_->doc_, ret);
+		} else if (simdjson::SUCCESS == (error = state_->doc_.at_pointer(pointer).get(val))) {
+			error = toValue(val, ret);
+		}
+		if (simdjson::SUCCESS != error) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in getting " << pointer << ": " << simdjson::error_message(error) << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		return ret;
+#else
+		const Json::Value * val = find(pointer);
+		if (nullptr == val) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error, no value at " << pointer << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		return *val;
+#endif
+	}
+
+#if defined(NJHCPP_USE_SIMDJSON)
+	/**@brief The underlying on demand document, for reading fields directly without going through Json::Value
+	 *
+	 */
+	simdjson::ondemand::document & onDemand() {
+		return state_->doc_;
+	}
+#endif
+
+private:
+	JsonDocument() = default;
+
+#if defined(NJHCPP_USE_SIMDJSON)
+	//the document refers to the parser and the text so they're kept together and don't move
+	struct State {
+		simdjson::padded_string text_;
+		simdjson::ondemand::parser parser_;
+		simdjson::ondemand::document doc_;
+	};
+	std::unique_ptr<State> state_ = std::make_unique<State>();
+
+	void startDocument() {
+		auto error = state_->parser_.iterate(state_->text_).get(state_->doc_);
+		if (simdjson::SUCCESS != error) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in parsing: " << simdjson::error_message(error) << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+
+	template<typename VAL>
+	static simdjson::error_code toValue(VAL & val, Json::Value & out) {
+		simdjson::ondemand::json_type type;
+		auto error = val.type().get(type);
+		if (error) {
+			return error;
+		}
+		switch (type) {
+		case simdjson::ondemand::json_type::object: {
+			out = Json::Value(Json::objectValue);
+			simdjson::ondemand::object obj;
+			if ((error = val.get_object().get(obj))) {
+				return error;
+			}
+			for (auto field : obj) {
+				std::string_view key;
+				simdjson::ondemand::value child;
+				if ((error = field.unescaped_key().get(key)) || (error = field.value().get(child))) {
+					return error;
+				}
+				if ((error = toValue(child, out[std::string(key)]))) {
+					return error;
+				}
+			}
+			break;
+		}
+		case simdjson::ondemand::json_type::array: {
+			out = Json::Value(Json::arrayValue);
+			simdjson::ondemand::array arr;
+			if ((error = val.get_array().get(arr))) {
+				return error;
+			}
+			Json::ArrayIndex pos = 0;
+			for (auto element : arr) {
+				simdjson::ondemand::value child;
+				if ((error = element.get(child)) || (error = toValue(child, out[pos++]))) {
+					return error;
+				}
+			}
+			break;
+		}
+		case simdjson::ondemand::json_type::string: {
+			std::string_view str;
+			if ((error = val.get_string().get(str))) {
+				return error;
+			}
+			out = Json::Value(str.data(), str.data() + str.size());
+			break;
+		}
+		case simdjson::ondemand::json_type::number: {
+			simdjson::ondemand::number_type numType;
+			if ((error = val.get_number_type().get(numType))) {
+				return error;
+			}
+			if (simdjson::ondemand::number_type::signed_integer == numType) {
+				int64_t num = 0;
+				error = val.get_int64().get(num);
+				out = Json::Value(Json::Int64(num));
+			} else if (simdjson::ondemand::number_type::unsigned_integer == numType) {
+				uint64_t num = 0;
+				error = val.get_uint64().get(num);
+				out = Json::Value(Json::UInt64(num));
+			} else if (simdjson::ondemand::number_type::big_integer == numType) {
+				//too big for 64 bits, jsoncpp makes these doubles
+				std::string_view raw;
+				error = simdjson::simdjson_result<std::string_view>(val.raw_json_token()).get(raw);
+				out = Json::Value(std::strtod(std::string(raw).c_str(), nullptr));
+			} else {
+				double num = 0;
+				error = val.get_double().get(num);
+				out = Json::Value(num);
+			}
+			break;
+		}
+		case simdjson::ondemand::json_type::boolean: {
+			bool b = false;
+			error = val.get_bool().get(b);
+			out = Json::Value(b);
+			break;
+		}
+		case simdjson::ondemand::json_type::null:
+			out = Json::Value(Json::nullValue);
+			break;
+		default:
+			return simdjson::INCORRECT_TYPE;
+		}
+		return error;
+	}
+#else
+	Json::Value root_;
+
+	void parseRoot(std::string_view text, const std::string & name) {
+		std::string errs;
+		if (!impl::parseJsoncpp(text, root_, errs)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in parsing " << name << "\n";
+			ss << errs << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+
+	const Json::Value * find(std::string_view pointer) const {
+		if (!pointer.empty() && '/' != pointer.front()) {
+			return nullptr;
+		}
+		const Json::Value * current = &root_;
+		while (!pointer.empty()) {
+			pointer.remove_prefix(1);
+			const size_t end = std::min(pointer.find('/'), pointer.size());
+			std::string token;
+			for (size_t pos = 0; pos < end; ++pos) {
+				if ('~' == pointer[pos] && pos + 1 < end && ('0' == pointer[pos + 1] || '1' == pointer[pos + 1])) {
+					token.push_back('0' == pointer[pos + 1] ? '~' : '/');
+					++pos;
+				} else {
+					token.push_back(pointer[pos]);
+				}
+			}
+			pointer.remove_prefix(end);
+			if (current->isObject()) {
+				current = current->find(token.data(), token.data() + token.size());
+			} else if (current->isArray() && !token.empty()
+					&& std::all_of(token.begin(), token.end(), [](char c) {return c >= '0' && c <= '9';})
+					&& token.size() < 20 && (token.size() == 1 || '0' != token.front())) {
+				const auto pos = std::stoull(token);
+				current = pos < current->size() ? &(*current)[Json::ArrayIndex(pos)] : nullptr;
+			} else {
+				current = nullptr;
+			}
+			if (nullptr == current) {
+				return nullptr;
+			}
+		}
+		return current;
+	}
+#endif
+};
+
+}  // namespace json
+}  // namespace njh
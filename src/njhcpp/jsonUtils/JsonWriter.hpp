@@ -0,0 +1,474 @@
+#pragma once
+/*
+ * JsonWriter.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <boost/filesystem.hpp>
+
+#include "njhcpp/jsonUtils/jsonUtils.hpp"
+#include "njhcpp/common/numFormatting.hpp"
+
+namespace njh {
+namespace json {
+
+class JsonWriter;
+
+namespace impl {
+struct check_has_writeJson {
+	template<typename X, void (X::*)(JsonWriter &) const = &X::writeJson>
+	struct get {
+	};
+};
+
+template<typename T, typename = void>
+struct isIterable : std::false_type {
+};
+template<typename T>
+struct isIterable<T, std::void_t<decltype(std::begin(std::declval<const T &>())), decltype(std::end(std::declval<const T &>()))>> : std::true_type {
+};
+
+template<typename T>
+struct isPair : std::false_type {
+};
+template<typename FIRST, typename SECOND>
+struct isPair<std::pair<FIRST, SECOND>> : std::true_type {
+};
+
+template<typename T>
+struct isSmartPtr : std::false_type {
+};
+template<typename T>
+struct isSmartPtr<std::shared_ptr<T>> : std::true_type {
+};
+template<typename T, typename DELETER>
+struct isSmartPtr<std::unique_ptr<T, DELETER>> : std::true_type {
+};
+}  // namespace impl
+
+/**@brief Writes json text straight from C++ values into a buffer without building a Json::Value tree first
+ *
+ * Takes the same values as njh::json::toJson() (numbers, strings, paths, containers with maps becoming objects, smart pointers,
+ * Json::Value and classes with toJson() const) and also classes with a void writeJson(JsonWriter &) const for writing themselves directly.
+ * Output goes to a std::string or is buffered and written to a std::ostream in large blocks, either on one line or indented.
+ * Floating point numbers are written in their shortest exact form so can differ in text (not value) from jsoncpp's 17 digits.
+ *
+ */
+class JsonWriter {
+public:
+	/**@brief Write by appending onto a string
+	 *
+	 * @param out the string to append to
+	 * @param pretty whether to indent, otherwise all on one line
+	 * @param indent the indentation for each level when pretty
+	 */
+	explicit JsonWriter(std::string & out, bool pretty = false, std::string indent = "\t") :
+			buf_(&out), pretty_(pretty), indent_(std::move(indent)) {
+	}
+
+	/**@brief Write to a stream, written in blocks of about flushSize bytes and on flush() or destruction
+	 *
+	 * @param out the stream to write to
+	 * @param pretty whether to indent, otherwise all on one line
+	 * @param indent the indentation for each level when pretty
+	 * @param flushSize how much to buffer before writing
+	 */
+	explicit JsonWriter(std::ostream & out, bool pretty = false, std::string indent = "\t", size_t flushSize = 64 * 1024) :
+			buf_(&ownBuffer_), sink_(&out), pretty_(pretty), indent_(std::move(indent)), flushSize_(flushSize) {
+		ownBuffer_.reserve(flushSize_ + 1024);
+	}
+
+	~JsonWriter() {
+		if (nullptr != sink_ && !ownBuffer_.empty()) {
+			try {
+				flush();
+			} catch (...) {
+			}
+		}
+	}
+
+	JsonWriter(const JsonWriter &) = delete;
+	JsonWriter & operator=(const JsonWriter &) = delete;
+
+	/**@brief Write anything buffered to the stream
+	 *
+	 */
+	void flush() {
+		if (nullptr != sink_) {
+			sink_->write(ownBuffer_.data(), ownBuffer_.size());
+			ownBuffer_.clear();
+			sink_->flush();
+		}
+	}
+
+	JsonWriter & startObject() {
+		beforeValue();
+		buf_->push_back('{');
+		levels_.emplace_back(Level { true, 0 });
+		return *this;
+	}
+
+	JsonWriter & endObject() {
+		return endLevel(true, '}');
+	}
+
+	JsonWriter & startArray() {
+		beforeValue();
+		buf_->push_back('[');
+		levels_.emplace_back(Level { false, 0 });
+		return *this;
+	}
+
+	JsonWriter & endArray() {
+		return endLevel(false, ']');
+	}
+
+	/**@brief Write a key in the current object, to be followed by its value
+	 *
+	 * @param name the key
+	 * @return this writer
+	 */
+	JsonWriter & key(std::string_view name) {
+		if (levels_.empty() || !levels_.back().object_ || afterKey_) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: key " + std::string(name)
+					+ " can only be written directly inside an object" };
+		}
+		beforeValue();
+		appendString(name);
+		buf_->append(pretty_ ? " : " : ":");
+		afterKey_ = true;
+		return *this;
+	}
+
+	/**@brief Write a key and its value
+	 *
+	 * @param name the key
+	 * @param val the value
+	 * @return this writer
+	 */
+	template<typename T>
+	JsonWriter & member(std::string_view name, const T & val) {
+		key(name);
+		return value(val);
+	}
+
+	JsonWriter & null() {
+		beforeValue();
+		buf_->append("null");
+		return afterValue();
+	}
+
+	/**@brief Write a value
+	 *
+	 * @param val the value
+	 * @return this writer
+	 */
+	template<typename T>
+	JsonWriter & value(const T & val) {
+		typedef typename std::decay<T>::type Decayed;
+		if constexpr (std::is_same<Decayed, Json::Value>::value) {
+			writeJsonValue(val);
+			return *this;
+		} else if constexpr (std::is_same<Decayed, bool>::value) {
+			beforeValue();
+			buf_->append(val ? "true" : "false");
+		} else if constexpr (std::is_same<Decayed, char>::value) {
+			beforeValue();
+			appendString(std::string_view(&val, 1));
+		} else if constexpr (std::is_floating_point<Decayed>::value) {
+			beforeValue();
+			appendFloat(val);
+		} else if constexpr (std::is_integral<Decayed>::value) {
+			//int8_t and uint8_t are numbers as with toJson()
+			beforeValue();
+			if constexpr (std::is_signed<Decayed>::value) {
+				appendNum(*buf_, static_cast<int64_t>(val));
+			} else {
+				appendNum(*buf_, static_cast<uint64_t>(val));
+			}
+		} else if constexpr (std::is_null_pointer<Decayed>::value) {
+			return null();
+		} else if constexpr (std::is_convertible<const T &, std::string_view>::value) {
+			if constexpr (std::is_pointer<T>::value) {
+				if (nullptr == val) {
+					return null();
+				}
+			}
+			beforeValue();
+			appendString(std::string_view(val));
+		} else if constexpr (std::is_same<Decayed, boost::filesystem::path>::value) {
+			beforeValue();
+			appendString(val.string());
+		} else if constexpr (impl::isSmartPtr<Decayed>::value) {
+			if (nullptr == val) {
+				return null();
+			}
+			return value(*val);
+		} else if constexpr (has_member<Decayed, impl::check_has_writeJson>::value) {
+			const size_t depth = levels_.size();
+			val.writeJson(*this);
+			if (levels_.size() != depth) {
+				throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: writeJson() left an object or array open" };
+			}
+			//writeJson() did its own afterValue() calls
+			return *this;
+		} else if constexpr (JsonConversion::converter::class_has_toJson<Decayed>::value) {
+			writeJsonValue(val.toJson());
+			return *this;
+		} else if constexpr (impl::isPair<Decayed>::value) {
+			startArray();
+			value(val.first);
+			value(val.second);
+			return endArray();
+		} else if constexpr (impl::isIterable<Decayed>::value) {
+			typedef typename std::decay<decltype(*std::begin(val))>::type Element;
+			if constexpr (impl::isPair<Element>::value) {
+				//maps become objects like with toJson()
+				startObject();
+				for (const auto & element : val) {
+					if constexpr (std::is_convertible<const typename Element::first_type &, std::string_view>::value) {
+						key(element.first);
+					} else {
+						key(estd::to_string(element.first));
+					}
+					value(element.second);
+				}
+				return endObject();
+			} else {
+				startArray();
+				for (const auto & element : val) {
+					value(element);
+				}
+				return endArray();
+			}
+		} else {
+			static_assert(!std::is_same<Decayed, Decayed>::value, "njh::json::JsonWriter doesn't know how to write this type");
+		}
+		return afterValue();
+	}
+
+	/**@brief Whether all started objects and arrays have been ended
+	 *
+	 * @return true if complete
+	 */
+	bool complete() const {
+		return levels_.empty() && !afterKey_;
+	}
+
+private:
+	struct Level {
+		bool object_; /**< object or array */
+		uint64_t count_; /**< values written so far */
+	};
+
+	std::string ownBuffer_; /**< the buffer when writing to a stream */
+	std::string * buf_; /**< where the text goes */
+	std::ostream * sink_ = nullptr; /**< the stream ownBuffer_ is written to, if any */
+	bool pretty_ = false;
+	std::string indent_;
+	size_t flushSize_ = 0;
+	std::vector<Level> levels_; /**< the open objects and arrays */
+	bool afterKey_ = false; /**< a key was just written so the next value goes with it */
+
+	void newLine(size_t depth) {
+		buf_->push_back('\n');
+		for (size_t level = 0; level < depth; ++level) {
+			buf_->append(indent_);
+		}
+	}
+
+	void beforeValue() {
+		if (afterKey_) {
+			afterKey_ = false;
+			return;
+		}
+		if (levels_.empty()) {
+			return;
+		}
+		if (levels_.back().count_ > 0) {
+			buf_->push_back(',');
+		}
+		if (pretty_) {
+			newLine(levels_.size());
+		}
+	}
+
+	JsonWriter & afterValue() {
+		if (!levels_.empty()) {
+			++levels_.back().count_;
+		}
+		if (nullptr != sink_ && ownBuffer_.size() >= flushSize_) {
+			sink_->write(ownBuffer_.data(), ownBuffer_.size());
+			ownBuffer_.clear();
+		}
+		return *this;
+	}
+
+	JsonWriter & endLevel(bool object, char closing) {
+		if (levels_.empty() || levels_.back().object_ != object || afterKey_) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: no open " + (object ? "object" : "array") + " to end" };
+		}
+		const bool hadValues = levels_.back().count_ > 0;
+		levels_.pop_back();
+		if (pretty_ && hadValues) {
+			newLine(levels_.size());
+		}
+		buf_->push_back(closing);
+		return afterValue();
+	}
+
+	void appendString(std::string_view str) {
+		static const char hexDigits[] = "0123456789abcdef";
+		buf_->push_back('"');
+		size_t runStart = 0;
+		for (size_t pos = 0; pos < str.size(); ++pos) {
+			const unsigned char c = str[pos];
+			if (c >= 0x20 && c != '"' && c != '\\') {
+				continue;
+			}
+			buf_->append(str.data() + runStart, pos - runStart);
+			runStart = pos + 1;
+			switch (c) {
+			case '"':
+				buf_->append("\\\"");
+				break;
+			case '\\':
+				buf_->append("\\\\");
+				break;
+			case '\n':
+				buf_->append("\\n");
+				break;
+			case '\t':
+				buf_->append("\\t");
+				break;
+			case '\r':
+				buf_->append("\\r");
+				break;
+			case '\b':
+				buf_->append("\\b");
+				break;
+			case '\f':
+				buf_->append("\\f");
+				break;
+			default:
+				buf_->append("\\u00");
+				buf_->push_back(hexDigits[c >> 4]);
+				buf_->push_back(hexDigits[c & 0xF]);
+				break;
+			}
+		}
+		buf_->append(str.data() + runStart, str.size() - runStart);
+		buf_->push_back('"');
+	}
+
+	template<typename T>
+	void appendFloat(T val) {
+		//as jsoncpp writes them
+		if (std::isnan(val)) {
+			buf_->append("null");
+			return;
+		}
+		if (std::isinf(val)) {
+			buf_->append(val < 0 ? "-1e+9999" : "1e+9999");
+			return;
+		}
+		const size_t start = buf_->size();
+		appendNum(*buf_, val, FloatFormat::SHORTEST);
+		//keep it a real number when read back
+		if (std::string::npos == buf_->find_first_of(".e", start)) {
+			buf_->append(".0");
+		}
+	}
+
+	void writeJsonValue(const Json::Value & val) {
+		switch (val.type()) {
+		case Json::nullValue:
+			beforeValue();
+			buf_->append("null");
+			break;
+		case Json::intValue:
+			beforeValue();
+			appendNum(*buf_, val.asLargestInt());
+			break;
+		case Json::uintValue:
+			beforeValue();
+			appendNum(*buf_, val.asLargestUInt());
+			break;
+		case Json::realValue:
+			beforeValue();
+			appendFloat(val.asDouble());
+			break;
+		case Json::stringValue: {
+			beforeValue();
+			const char * begin = nullptr;
+			const char * end = nullptr;
+			val.getString(&begin, &end);
+			appendString(std::string_view(begin, end - begin));
+			break;
+		}
+		case Json::booleanValue:
+			beforeValue();
+			buf_->append(val.asBool() ? "true" : "false");
+			break;
+		case Json::arrayValue:
+			startArray();
+			//by index since iterating skips never set elements that are still written as null
+			for (Json::ArrayIndex pos = 0; pos < val.size(); ++pos) {
+				writeJsonValue(val[pos]);
+			}
+			endArray();
+			return;
+		case Json::objectValue:
+			startObject();
+			for (auto it = val.begin(); it != val.end(); ++it) {
+				key(it.name());
+				writeJsonValue(*it);
+			}
+			endObject();
+			return;
+		}
+		afterValue();
+	}
+};
+
+/**@brief Write a value as json to a stream without building a Json::Value, see njh::json::JsonWriter
+ *
+ * @param val the value
+ * @param out the stream
+ * @param pretty whether to indent, otherwise all on one line
+ */
+template<typename T>
+void writeJson(const T & val, std::ostream & out, bool pretty = false) {
+	JsonWriter writer(out, pretty);
+	writer.value(val);
+	writer.flush();
+}
+
+/**@brief Get the json text of a value without building a Json::Value, see njh::json::JsonWriter
+ *
+ * @param val the value
+ * @param pretty whether to indent, otherwise all on one line
+ * @return the json text
+ */
+template<typename T>
+std::string toJsonStr(const T & val, bool pretty = false) {
+	std::string ret;
+	JsonWriter writer(ret, pretty);
+	writer.value(val);
+	return ret;
+}
+
+}  // namespace json
+}  // namespace njh
@@ -21,6 +21,7 @@
 #include "njhcpp/utils/has_member.hpp" //has_member
 #include "njhcpp/debug/exception.hpp" //Exception
 #include "njhcpp/utils/lexical_cast.hpp" //lexical_cast
+#include "njhcpp/jsonUtils/JsonParsing.hpp" //impl::parseText
 
 namespace njh {
 /**@brief Namespace for dealing with conversion to json
@@ -326,39 +327,61 @@ Json::Value toJson(const T & t) {
 
 
 
+/**@brief Parse a string into a Json::Value object
+ *
+ * @param jsonStr String formated in json
+ * @return A Json::Value object
+ */
+inline Json::Value parse(std::string_view jsonStr) {
+	Json::Value root;
+	std::string errs;
+	if (!impl::parseText(jsonStr, jsonStr.size(), root, errs)) {
+		std::stringstream ss;
+		ss << "Error in parsing jsonStr in " << __PRETTY_FUNCTION__ << "\n";
+		ss << impl::jsonSnippet(jsonStr) << "\n";
+		ss << errs << "\n";
+		throw std::runtime_error{ss.str()};
+	}
+	return root;
+}
+
 /**@brief Parse a string into a Json::Value object
  *
  * @param jsonStr String formated in json
  * @return A Json::Value object
  */
 inline Json::Value parse(const std::string & jsonStr) {
-	Json::CharReaderBuilder readerBuilder;
-	std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
 	Json::Value root;
 	std::string errs;
-	auto stats = reader->parse(jsonStr.c_str(), jsonStr.c_str() + jsonStr.size(), &root, &errs);
-	if (!stats) {
+	if (!impl::parseText(jsonStr, jsonStr.capacity(), root, errs)) {
 		std::stringstream ss;
 		ss << "Error in parsing jsonStr in " << __PRETTY_FUNCTION__ << "\n";
-		ss << jsonStr << "\n";
+		ss << impl::jsonSnippet(jsonStr) << "\n";
 		ss << errs << "\n";
 		throw std::runtime_error{ss.str()};
 	}
 	return root;
 }
 
-/**@brief Parse json file and create Json::Value object
+/**@brief Parse a string into a Json::Value object
+ *
+ * @param jsonStr String formated in json
+ * @return A Json::Value object
+ */
+inline Json::Value parse(const char * jsonStr) {
+	return parse(std::string_view(jsonStr));
+}
+
+/**@brief Parse json file and create Json::Value object, the file is memory mapped rather than read through a stream
  *
  * @param filename the file to  read in
  * @return a Json::Value object with the contents of filename
  */
 inline Json::Value parseFile(const std::string & filename) {
-	Json::CharReaderBuilder readerBuilder;
 	Json::Value root;
 	std::string errs;
-	std::ifstream inFile{filename};
-	auto stats = Json::parseFromStream(readerBuilder, inFile, &root, &errs);
-	if (!stats) {
+	impl::MappedFile inFile(filename);
+	if (!impl::parseText(inFile.view(), inFile.capacity(), root, errs)) {
 		std::stringstream ss;
 		ss << "Error in parsing from file: " << filename << " in " << __PRETTY_FUNCTION__ << "\n";
 		ss << errs << "\n";
@@ -373,11 +396,10 @@ inline Json::Value parseFile(const std::string & filename) {
  * @return the Json in the input stream
  */
 inline Json::Value parseStream(std::istream & is){
-	Json::CharReaderBuilder readerBuilder;
 	Json::Value root;
 	std::string errs;
-	auto stats = Json::parseFromStream(readerBuilder, is, &root, &errs);
-	if (!stats) {
+	const std::string text{std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+	if (!impl::parseText(text, text.capacity(), root, errs)) {
 		std::stringstream ss;
 		ss << "Error in parsing from stream in " << __PRETTY_FUNCTION__ << "\n";
 		ss << errs << "\n";
@@ -386,15 +408,30 @@ inline Json::Value parseStream(std::istream & is){
 	return root;
 }
 
+namespace impl {
+/**@brief A one line (no indentation) writer per thread so writeAsOneLine() doesn't set up a StreamWriterBuilder on every call
+ *
+ * @return this thread's writer
+ */
+inline Json::StreamWriter & oneLineWriter() {
+	thread_local std::unique_ptr<Json::StreamWriter> writer = []() {
+		Json::StreamWriterBuilder writerBuilder;
+		writerBuilder["indentation"] = "";
+		return std::unique_ptr<Json::StreamWriter>(writerBuilder.newStreamWriter());
+	}();
+	return *writer;
+}
+}  // namespace impl
+
 /**@brief Write a json formated string with little white space, one line
  *
  * @param val The json object
  * @return A string with only one line with values in val written in json format
  */
 inline std::string writeAsOneLine(const Json::Value & val) {
-	Json::StreamWriterBuilder writerBuilder;
-	writerBuilder["indentation"] = "";
-	return Json::writeString(writerBuilder,val);
+	std::ostringstream out;
+	impl::oneLineWriter().write(val, &out);
+	return out.str();
 }
 
 
@@ -404,10 +441,7 @@ inline std::string writeAsOneLine(const Json::Value & val) {
  * @param out the stream to write to
  */
 inline void writeAsOneLine(const Json::Value & val, std::ostream & out) {
-	Json::StreamWriterBuilder writerBuilder;
-	writerBuilder.settings_["indentation"] = "";
-	std::unique_ptr<Json::StreamWriter> writer(writerBuilder.newStreamWriter());
-	writer->write(val, &out);
+	impl::oneLineWriter().write(val, &out);
 }
 
 /**@brief convert a json array to a vector using a function to convert the json to cpp type
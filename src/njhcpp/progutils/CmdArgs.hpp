@@ -767,73 +767,74 @@ inline void CmdArgs::convertArg(const std::string& option, bool & outVal) {
 		outVal = true;
 	}
 }
+// numbers are parsed strictly with njh::parseNum (std::from_chars), the whole argument has to be the number
 // short (int16_t)
 template<>
 inline void CmdArgs::convertArg(const std::string& option, short & outVal) {
-	outVal = estd::stos(option);
+	outVal = parseNum<short>(option);
 }
 // int (int32_t)
 template<>
 inline void CmdArgs::convertArg(const std::string& option, int& outVal) {
-	outVal = std::stoi(option);
+	outVal = parseNum<int>(option);
 }
 // long (int64_t depending on system/lib)
 template<>
 inline void CmdArgs::convertArg(const std::string& option, long & outVal) {
-	outVal = std::stol(option);
+	outVal = parseNum<long>(option);
 }
 
 // long long (int64_t depending on system/lib)
 template<>
 inline void CmdArgs::convertArg(const std::string& option, long long& outVal) {
-	outVal = std::stoll(option);
+	outVal = parseNum<long long>(option);
 }
 // unsigned char (uint8_t)
 template<>
 inline void CmdArgs::convertArg(const std::string& option,
 		unsigned char& outVal) {
-	outVal = estd::stouc(option);
+	outVal = parseNum<unsigned char>(option);
 }
 // unsigned short (uint16_t)
 template<>
 inline void CmdArgs::convertArg(const std::string& option,
 		unsigned short& outVal) {
-	outVal = estd::stous(option);
+	outVal = parseNum<unsigned short>(option);
 }
 // unsigned int (uint32_t)
 template<>
 inline void CmdArgs::convertArg(const std::string& option,
 		unsigned int& outVal) {
-	outVal = estd::stou(option);
+	outVal = parseNum<unsigned int>(option);
 }
 // unsigned long (size_t and on some systems/libs uint64_t)
 template<>
 inline void CmdArgs::convertArg(const std::string& option,
 		unsigned long& outVal) {
-	outVal = std::stoul(option);
+	outVal = parseNum<unsigned long>(option);
 }
 
 // unsigned long long (uint64_t depending on the system/lib)
 template<>
 inline void CmdArgs::convertArg(const std::string& option,
 		unsigned long long& outVal) {
-	outVal = std::stoull(option);
+	outVal = parseNum<unsigned long long>(option);
 }
 // double
 template<>
 inline void CmdArgs::convertArg(const std::string& option, double& outVal) {
-	outVal = std::stod(option);
+	outVal = parseNum<double>(option);
 }
 // long double
 template<>
 inline void CmdArgs::convertArg(const std::string& option,
 		long double& outVal) {
-	outVal = std::stold(option);
+	outVal = parseNum<long double>(option);
 }
 // float
 template<>
 inline void CmdArgs::convertArg(const std::string& option, float& outVal) {
-	outVal = std::stof(option);
+	outVal = parseNum<float>(option);
 }
 
 
@@ -10,7 +10,15 @@
 #include "njhcpp/utils.h"
 #include "njhcpp/progutils/programSetUp.hpp"
 #include "njhcpp/concurrency.h"
+#include "njhcpp/IO/JsonRecordReader.hpp"
 #include <thread>
+#include <regex>
+#include <limits>
+#include <atomic>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
 namespace njh{
 namespace progutils {
 
@@ -46,6 +54,11 @@ class ProgramRunner {
    */
   const std::map<std::string, funcInfo> cmdToFunc_;
 
+  /**@brief An index of the names in cmdToFunc_ for finding the closest names to an unrecognized command
+   *
+   */
+  const BKTree programIndex_;
+
  public:
   /**@brief Name of master program that holds the sub-programs
    *
@@ -76,7 +89,7 @@ class ProgramRunner {
 								std::string versionMajor = "1",
 								std::string versionMinor = "0",
 								std::string versionPatchLevel = "0")
-      : cmdToFunc_(cmdToFunc), nameOfProgram_(nameOfProgram),
+      : cmdToFunc_(cmdToFunc), programIndex_(getVecOfMapKeys(cmdToFunc_)), nameOfProgram_(nameOfProgram),
 				versionMajor_(versionMajor),
 				versionMinor_(versionMinor),
 				versionPatchlevel_(versionPatchLevel) {
@@ -177,26 +190,43 @@ class ProgramRunner {
   virtual bool containsProgram(const std::string &program) const {
     return cmdToFunc_.find(program) != cmdToFunc_.end();
   }
-	/** @brief A function to find closest matching sub-program, done by giving the
-	 *program with the highest global alignment score to the input parameter
-	 *program
+	/** @brief A function to find closest matching sub-program, done by finding the
+	 *program name with the smallest edit distance to the input parameter program
 	 *
 	 * @param program The program to compare to the sub-programs
+	 * @return the title of the closest program and a score of how close, the negative of the edit distance so higher is closer
+	 * and scores from different runners (e.g. OneRing's rings) compare by distance alone, std::numeric_limits<int>::min() with an empty title if there's no match
 	 */
 	virtual std::pair<std::string, int> closestProgram(
 			const std::string &program) const {
-		std::pair<std::string, int> ret = { "", 0 };
+		std::pair<std::string, int> ret = { "", std::numeric_limits<int>::min() };
 		if ("" == program) {
 			return ret;
 		}
-		for (const auto &prog : cmdToFunc_) {
-			int32_t currentScore = needleScore(program, prog.first);
-			if (currentScore > ret.second) {
-				ret = {prog.second.title_, currentScore};
-			}
+		const auto closest = programIndex_.closest(strToLowerRet(program), 1);
+		if (!closest.empty()) {
+			const auto &name = programIndex_.word(closest.front().wordIdx_);
+			ret = {cmdToFunc_.at(name).title_, -static_cast<int>(closest.front().dist_)};
 		}
 		return ret;
 	}
+
+	/** @brief Get the closest sub-programs to an unrecognized program, e.g. for suggestions or shell completion
+	 *
+	 * @param program The program to compare to the sub-programs
+	 * @param k The max number of sub-programs to return
+	 * @param maxDist Only return sub-programs within this many edits
+	 * @return the titles of the closest sub-programs, closest first
+	 */
+	virtual std::vector<std::string> suggestPrograms(const std::string &program,
+			uint32_t k, uint32_t maxDist = 3) const {
+		std::vector<std::string> ret;
+		for (const auto &match : programIndex_.closest(strToLowerRet(program), k, maxDist)) {
+			ret.emplace_back(cmdToFunc_.at(programIndex_.word(match.wordIdx_)).title_);
+		}
+		return ret;
+	}
+
   /**@brief A function to run a subprogram with same parameters but on all files
    *with a certain file extension
    *
@@ -206,82 +236,7 @@ class ProgramRunner {
    *
    */
   virtual int batchRun(CmdArgs inputCommands) {
-    std::vector<std::string> batchFlags{"-ending", "--ending", "-pattern", "--pattern", "-run", "--run", "batch"};
-    std::string ending = "", program = "", pattern = "";
-    ProgramSetUp setUp(inputCommands);
-    bool endFlag = setUp.setOption(ending , "-ending", "A file extension to run batch commands on", false);
-    setUp.setOption(pattern, "-pattern", "File Pattern to run batch command", !endFlag);
-    setUp.setOption(program, "-run", "ProgramToRun", true);
-    if(setUp.commands_.gettingFlags()){
-    	std::cout << bashCT::boldGreen("Batch") << bashCT::boldBlack(" Commands") << std::endl;
-    	setUp.printFlags(std::cout);
-    	if(program != ""){
-    		inputCommands.subProgram_ = program;
-        for(const auto & flag : batchFlags){
-        	inputCommands.removeArgumentCaseInsen(flag);
-        }
-      	std::cout << bashCT::boldGreen(program) << bashCT::boldBlack(" Commands") << std::endl;
-        runProgram(inputCommands);
-    	}
-    	exit(1);
-    }
-    setUp.printWarnings(std::cout);
-    if (setUp.failed_) {
-      exit(1);
-    }
-
-    // erase the batchRun flags to remove
-    bool overWrite = false;
-    bool exitOnFailureToWrite = true;
-    // create run log
-    std::ofstream runLog;
-    std::string nameOfRunLog =
-        "batchRunLog_" + inputCommands.masterProgram_ + "-" + program + "_" + getCurrentDate() + ".txt";
-    files::openTextFile(runLog, nameOfRunLog, ".txt", overWrite, exitOnFailureToWrite);
-    runLog << "Ran " << getCurrentDate() << std::endl;
-    runLog << "Ran from: " << inputCommands.workingDir_ << std::endl;
-    runLog << inputCommands.commandLine_ << std::endl;
-    for(const auto & flag : batchFlags){
-    	inputCommands.removeArgumentCaseInsen(flag);
-    }
-    inputCommands.subProgram_ = program;
-    // gather the necessary files
-    if(endFlag){
-    	pattern = ".*" + ending;
-    }
-    std::vector<files::bfs::path> specificFiles;
-  	auto allFiles = njh::files::filesInFolder(".");
-  	for(const auto & f : allFiles){
-  		if(std::regex_match(f.filename().string(),std::regex{pattern})){
-  			specificFiles.emplace_back(f);
-  		}
-  	}
-    // run the command on each file
-    for (const auto &file : specificFiles) {
-      if (containsSubString(file.string(), "batchRunLog")) {
-        continue;
-      }
-      CmdArgs currentCommands = inputCommands;
-      for (auto &com : currentCommands.arguments_) {
-        com.second = replaceString(com.second, "THIS", file.filename().string() );
-      }
-      currentCommands.resetCommandLine();
-      // log current run command
-      std::cout << currentCommands.commandLine_ << std::endl;
-      runLog << currentCommands.commandLine_ << std::endl;
-      std::cout << std::endl;
-      // run the current command
-      stopWatch watch;
-      runProgram(currentCommands);
-      std::cout << "\tCurrent Command Run Time: " << watch.totalTimeFormatted(6) << std::endl;
-      runLog << "\tCurrent Command Run Time: " << watch.totalTimeFormatted(6) << std::endl;
-      setUp.logRunTime(runLog);
-      setUp.logRunTime(std::cout);
-      std::cout << std::endl;
-    }
-    setUp.logRunTime(runLog);
-    setUp.logRunTime(std::cout);
-    return 0;
+    return runBatch(inputCommands, false);
   }
   /**@brief A function to run a subprogram with same parameters but on all files
    *with a certain file extension
@@ -293,14 +248,45 @@ class ProgramRunner {
    *
    */
   virtual int batchRunThreaded(CmdArgs inputCommands) {
-    std::vector<std::string> batchFlags{"-ending", "--ending", "-pattern", "--pattern", "-run", "--run", "batchthreaded", "-batchthreads", "--batchthreads"};
+    return runBatch(inputCommands, true);
+  }
+
+
+ protected:
+  /**@brief The engine behind batchRun() and batchRunThreaded(), runs the subprogram once per matching file on a pool of threads
+   *
+   * Each job's stdout and stderr go to their own files in a batchRunLogs_ directory, either by running the job in a forked
+   * process (-forkJobs, which also keeps a crashing job from taking down the batch) or, when running on one thread,
+   * by redirecting std::cout and std::cerr. In-process jobs on several threads print to the terminal as before.
+   * Every job is recorded in a JSON Lines log (file, command, return code, time, output files) and -resume skips the files
+   * a previous run of the same batch logged as succeeded, a cut off last line from a run that died is skipped with a warning.
+   * A job that throws, or that can't be forked, is logged as failed with the error rather than stopping the batch.
+   *
+   * @param inputCommands the batch command line
+   * @param threaded whether called as batchThreaded, which adds the -batchThreads option
+   * @return 0 if every job succeeded, 1 otherwise
+   */
+  virtual int runBatch(CmdArgs inputCommands, bool threaded) {
+    std::vector<std::string> batchFlags{"-ending", "--ending", "-pattern", "--pattern", "-run", "--run",
+    	"-forkJobs", "--forkJobs", "-resume", "--resume"};
+    if (threaded) {
+    	batchFlags.insert(batchFlags.end(), {"batchthreaded", "-batchthreads", "--batchthreads"});
+    } else {
+    	batchFlags.emplace_back("batch");
+    }
     std::string ending = "", program = "", pattern = "";
+    uint32_t numThreads = threaded ? 2 : 1;
+    bool forkJobs = false;
+    bool resume = false;
     ProgramSetUp setUp(inputCommands);
     bool endFlag = setUp.setOption(ending , "-ending", "A file extension to run batch commands on", false);
     setUp.setOption(pattern, "-pattern", "File Pattern to run batch command", !endFlag);
-    setUp.setOption(program, "-run", "Program To Run a Batch of Commands with", true);
-    uint32_t numThreads = 2;
-    setUp.setOption(numThreads, "-batchThreads", "Number of Threads use for the batch commands");
+    setUp.setOption(program, "-run", threaded ? "Program To Run a Batch of Commands with" : "ProgramToRun", true);
+    if (threaded) {
+    	setUp.setOption(numThreads, "-batchThreads", "Number of Threads use for the batch commands");
+    }
+    setUp.setOption(forkJobs, "-forkJobs", "Run each command in its own process, capturing its output to its own files");
+    setUp.setOption(resume, "-resume", "Skip files that succeeded in a previous run of this batch");
     if(setUp.commands_.gettingFlags()){
     	std::cout << bashCT::boldGreen("Batch") << bashCT::boldBlack(" Commands") << std::endl;
     	setUp.printFlags(std::cout);
@@ -338,54 +324,219 @@ class ProgramRunner {
     if(endFlag){
     	pattern = ".*" + ending;
     }
+    const std::regex patternReg{pattern};
     std::vector<files::bfs::path> specificFiles;
   	auto allFiles = njh::files::filesInFolder(".");
   	for(const auto & f : allFiles){
-  		if(std::regex_match(f.filename().string(),std::regex{pattern})){
+  		if(!containsSubString(f.string(), "batchRunLog") && std::regex_match(f.filename().string(), patternReg)){
   			specificFiles.emplace_back(f);
   		}
   	}
-    // run the command on each file
-    std::vector<std::shared_ptr<CmdArgs>> allCommands;
+  	std::sort(specificFiles.begin(), specificFiles.end());
+
+  	// the structured log and the per job output, named without a date so -resume can find them
+  	const std::string batchName = inputCommands.masterProgram_ + "-" + program;
+  	const files::bfs::path jobLogFnp = "batchRunLog_" + batchName + ".jsonl";
+  	const files::bfs::path outputDir = "batchRunLogs_" + batchName;
+  	std::map<std::string, Json::Value> previousSuccesses;
+  	if (resume && files::bfs::exists(jobLogFnp)) {
+  		JsonRecordReader reader{InOptions(jobLogFnp)};
+  		std::string lineText;
+  		std::string badLineError;
+  		while (reader.readNextRecordText(lineText)) {
+  			if (!badLineError.empty()) {
+  				//only the last line can have been cut off by the run dying
+  				throw std::runtime_error { badLineError };
+  			}
+  			Json::Value line;
+  			try {
+  				line = json::parse(lineText);
+  			} catch (const std::exception & e) {
+  				std::stringstream ss;
+  				ss << __PRETTY_FUNCTION__ << ", error in parsing record " << reader.recordsRead() << " of " << jobLogFnp << "\n" << e.what();
+  				badLineError = ss.str();
+  				continue;
+  			}
+  			for (const auto & uid : line.getMemberNames()) {
+  				if (line[uid].isObject() && line[uid].isMember("returnCode") && 0 == line[uid]["returnCode"].asInt()) {
+  					previousSuccesses[uid] = line[uid];
+  				}
+  			}
+  		}
+  		if (!badLineError.empty()) {
+  			std::cerr << "Warning, ignoring the cut off last line of " << jobLogFnp.string()
+  					<< ", the file it was for will be rerun" << std::endl;
+  		}
+  	}
+  	const bool captureOutput = forkJobs || numThreads <= 1;
+  	if (captureOutput) {
+  		files::bfs::create_directories(outputDir);
+  	}
+  	LockableJsonLog jobLog(jobLogFnp, true, LockableJsonLog::StreamingPars());
+
+    // set up the command for each file, carrying over the ones that already succeeded
+    std::vector<std::pair<std::string, CmdArgs>> jobs;
+    StringReplacer thisReplacer;
+    thisReplacer.addReplacement("THIS", "");
+    thisReplacer.compile();
     for (const auto &file : specificFiles) {
-      if (containsSubString(file.string(), "batchRunLog")) {
-        continue;
+      const std::string fileName = file.filename().string();
+      auto previous = previousSuccesses.find(fileName);
+      if (previousSuccesses.end() != previous) {
+      	Json::Value carried = previous->second;
+      	carried["resumed"] = true;
+      	jobLog.addToLog(fileName, carried);
+      	runLog << "Skipping, already succeeded: " << fileName << std::endl;
+      	continue;
       }
       CmdArgs currentCommands = inputCommands;
+      thisReplacer.setReplacement("THIS", fileName);
       for (auto &com : currentCommands.arguments_) {
-        com.second = replaceString(com.second, "THIS", file.filename().string() );
+        com.second = thisReplacer.replace(com.second);
       }
       currentCommands.resetCommandLine();
-      allCommands.emplace_back(std::make_shared<CmdArgs>(currentCommands));
+      jobs.emplace_back(fileName, currentCommands);
     }
-    concurrent::LockableQueue<std::shared_ptr<CmdArgs>> argPool(allCommands);
-  	std::vector<std::thread> threads;
-  	std::mutex logMut;
-  	auto runCmds = [this,&logMut,&runLog](concurrent::LockableQueue<std::shared_ptr<CmdArgs>> & pool){
-  				std::shared_ptr<CmdArgs> currentCmd;
-					while(pool.getVal(currentCmd)) {
-			      stopWatch watch;
-						runProgram(*currentCmd);
-						{
-							std::lock_guard<std::mutex> lock(logMut);
-							runLog << currentCmd->commandLine_ << std::endl;
-							runLog << "\tRun Time: " << watch.totalTimeFormatted(6) << std::endl;
-						}
-					}
-  	};
-  	for (uint32_t t = 0; t < numThreads; ++t) {
-  		threads.emplace_back(std::thread(runCmds, std::ref(argPool)));
-  	}
-  	for (auto &t : threads) {
-  		t.join();
-  	}
+
+    std::atomic<size_t> nextJob{0};
+    std::atomic<uint32_t> numFailed{0};
+    std::mutex logMut;
+    std::function<void()> runJobs = [&]() {
+    	size_t jobPos = nextJob++;
+    	while (jobPos < jobs.size()) {
+    		const auto & job = jobs[jobPos];
+    		Json::Value entry;
+    		entry["file"] = job.first;
+    		entry["commandLine"] = job.second.commandLine_;
+    		entry["start"] = getCurrentDateFull();
+    		const files::bfs::path stdOutFnp = outputDir / (job.first + ".stdout.txt");
+    		const files::bfs::path stdErrFnp = outputDir / (job.first + ".stderr.txt");
+    		stopWatch watch;
+    		int returnCode = 0;
+    		//an exception escaping a worker thread would terminate the whole batch
+    		try {
+    			if (forkJobs) {
+    				returnCode = runBatchJobForked(job.second, stdOutFnp, stdErrFnp);
+    			} else if (captureOutput) {
+    				returnCode = runBatchJobRedirected(job.second, stdOutFnp, stdErrFnp);
+    			} else {
+    				returnCode = runProgram(job.second);
+    			}
+    		} catch (const std::exception & e) {
+    			std::cerr << e.what() << std::endl;
+    			entry["error"] = e.what();
+    			returnCode = 1;
+    		}
+    		entry["returnCode"] = returnCode;
+    		entry["time"] = json::toJson(watch.totalTime());
+    		if (captureOutput) {
+    			entry["stdOut"] = stdOutFnp.string();
+    			entry["stdErr"] = stdErrFnp.string();
+    		}
+    		if (0 != returnCode) {
+    			++numFailed;
+    		}
+    		try {
+    			jobLog.addToLog(job.first, entry);
+    		} catch (const std::exception & e) {
+    			//without its log entry -resume will run the file again, so count it against the batch
+    			std::cerr << "Error in logging " << job.first << ": " << e.what() << std::endl;
+    			if (0 == returnCode) {
+    				++numFailed;
+    			}
+    		}
+    		{
+    			std::lock_guard<std::mutex> lock(logMut);
+    			runLog << job.second.commandLine_ << std::endl;
+    			runLog << "\tRun Time: " << watch.totalTimeFormatted(6) << ", return code: " << returnCode << std::endl;
+    			if (captureOutput) {
+    				std::cout << job.first << ": " << (0 == returnCode ? "done" : "failed, return code " + std::to_string(returnCode))
+    						<< " in " << watch.totalTimeFormatted(6) << ", output in " << stdOutFnp.string() << std::endl;
+    			}
+    		}
+    		jobPos = nextJob++;
+    	}
+    };
+    concurrent::runVoidFunctionThreaded(runJobs, std::max<uint32_t>(1, numThreads));
+    jobLog.writeLog();
     setUp.logRunTime(runLog);
     setUp.logRunTime(std::cout);
-    return 0;
+    return 0 == numFailed ? 0 : 1;
   }
 
+  /**@brief Run a batch job in this process with std::cout and std::cerr sent to files, only safe when one job runs at a time
+   *
+   * @param cmd the job's arguments
+   * @param stdOutFnp file for stdout
+   * @param stdErrFnp file for stderr
+   * @return the job's return code, 1 if it threw
+   */
+  int runBatchJobRedirected(const CmdArgs & cmd, const files::bfs::path & stdOutFnp,
+  		const files::bfs::path & stdErrFnp) {
+  	std::ofstream outFile(stdOutFnp.string());
+  	std::ofstream errFile(stdErrFnp.string());
+  	auto * oldOut = std::cout.rdbuf(outFile.rdbuf());
+  	auto * oldErr = std::cerr.rdbuf(errFile.rdbuf());
+  	int returnCode = 0;
+  	try {
+  		returnCode = runProgram(cmd);
+  	} catch (const std::exception & e) {
+  		std::cerr << e.what() << std::endl;
+  		returnCode = 1;
+  	}
+  	std::cout.rdbuf(oldOut);
+  	std::cerr.rdbuf(oldErr);
+  	return returnCode;
+  }
+
+  /**@brief Run a batch job in a forked process with its stdout and stderr sent to files
+   *
+   * This forks from a multithreaded process: the batch's LockableJsonLog writer thread is always running, as are the other
+   * batch threads with -batchThreads > 1. The child only gets the calling thread, so the subprogram mustn't need a lock
+   * another thread could have held at the fork. It exits with _exit() so the parent's destructors and atexit handlers don't run in it.
+   *
+   * @param cmd the job's arguments
+   * @param stdOutFnp file for stdout
+   * @param stdErrFnp file for stderr
+   * @return the job's return code, 128 plus the signal number if it was killed by a signal
+   */
+  int runBatchJobForked(const CmdArgs & cmd, const files::bfs::path & stdOutFnp,
+  		const files::bfs::path & stdErrFnp) {
+  	std::cout.flush();
+  	std::cerr.flush();
+  	const pid_t pid = ::fork();
+  	if (pid < 0) {
+  		std::stringstream ss;
+  		ss << __PRETTY_FUNCTION__ << ", error in forking for " << cmd.commandLine_ << ": " << std::strerror(errno) << "\n";
+  		throw std::runtime_error { ss.str() };
+  	}
+  	if (0 == pid) {
+  		int returnCode = 1;
+  		const int outFd = ::open(stdOutFnp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  		const int errFd = ::open(stdErrFnp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  		if (outFd >= 0 && errFd >= 0 && ::dup2(outFd, STDOUT_FILENO) >= 0 && ::dup2(errFd, STDERR_FILENO) >= 0) {
+  			try {
+  				returnCode = runProgram(cmd);
+  			} catch (const std::exception & e) {
+  				std::cerr << e.what() << std::endl;
+  				returnCode = 1;
+  			}
+  		}
+  		std::cout.flush();
+  		std::cerr.flush();
+  		std::fflush(nullptr);
+  		//skip the parent's atexit handlers and static destructors
+  		::_exit(returnCode & 0xFF);
+  	}
+  	int status = 0;
+  	while (pid != ::waitpid(pid, &status, 0) && EINTR == errno) {
+  	}
+  	if (WIFEXITED(status)) {
+  		return WEXITSTATUS(status);
+  	}
+  	return WIFSIGNALED(status) ? 128 + WTERMSIG(status) : 1;
+  }
 
- protected:
   /**@brief A function to add the subprogram funcInfo struct
    *
    * @param title The name of the subprogram
@@ -154,11 +154,12 @@ public:
 	void lookForInvalidOptions() {
 		auto flagStrs = flags_.getFlags();
 		strVecToLower(flagStrs);
+		const BKTree flagIndex(flagStrs);
 		for (const auto &com : commands_.arguments_) {
 			if (!contains(flagStrs, com.first)) {
 				warnings_.emplace_back(
 						bashCT::bold + bashCT::red + "Unrecognized option, " + com.first
-								+ "" + bashCT::reset);
+								+ closestFlagSuggestion(flagIndex, com.first) + bashCT::reset);
 				failed_ = true;
 			}
 		}
@@ -173,16 +174,32 @@ public:
 		for(auto & f : flagStrs){
 			lstrip(f, '-');
 		}
+		const BKTree flagIndex(flagStrs);
 		for (const auto &com : commands_.arguments_) {
 			if (!contains(flagStrs, lstripRet(com.first, '-'))) {
 				warnings_.emplace_back(
 						bashCT::bold + bashCT::red + "Unrecognized option, " + com.first
-								+ "" + bashCT::reset);
+								+ closestFlagSuggestion(flagIndex, lstripRet(com.first, '-')) + bashCT::reset);
 				failed_ = true;
 			}
 		}
 	}
 
+	/**@brief Get a suggestion of the closest flag for an unrecognized option
+	 *
+	 * @param flagIndex the index of the possible flags
+	 * @param option the unrecognized option
+	 * @return ", did you mean FLAG?" or an empty string if nothing is within a third of the option's length in edits (at least 2)
+	 */
+	static std::string closestFlagSuggestion(const BKTree & flagIndex,
+			const std::string & option) {
+		const auto closest = flagIndex.closest(option, 1, std::max<uint32_t>(2, option.size() / 3));
+		if (!closest.empty()) {
+			return ", did you mean " + flagIndex.word(closest.front().wordIdx_) + "?";
+		}
+		return "";
+	}
+
 	/**@brief Print any warnings incurred during set up to out
 	 * @param out The std::ostream out object to print to
 	 *
@@ -3,3 +3,8 @@
 
 #include "njhcpp/simulation/randomGenerator.hpp"
 #include "njhcpp/simulation/randObjGen.hpp"
+#include "njhcpp/simulation/WeightedSampler.hpp"
+#include "njhcpp/simulation/randomUtils.hpp"
+#include "njhcpp/simulation/randomEngines.hpp"
+#include "njhcpp/simulation/ReservoirSampler.hpp"
+#include "njhcpp/simulation/ParallelRandomStreams.hpp"
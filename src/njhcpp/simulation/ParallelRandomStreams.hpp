@@ -0,0 +1,139 @@
+#pragma once
+/*
+ * ParallelRandomStreams.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <vector>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+
+#include "njhcpp/simulation/randomGenerator.hpp"
+#include "njhcpp/concurrency/concurrencyUtils.hpp"
+
+namespace njh {
+
+/**@brief Threaded random generation that gives the same numbers for a seed no matter the number of threads or their scheduling
+ *
+ * The output of each call is split into fixed size chunks and chunk c of call b gets its own generator seeded
+ * with the master seed on stream (b << 32) + c, threads then take chunks as they go.
+ * Philox4x64 is the default engine since any of its streams can be made in constant time.
+ *
+ */
+template<typename ENGINE = Philox4x64>
+class ParallelRandomStreams {
+public:
+	typedef randomGeneratorT<ENGINE> generator_type;
+
+	/**@brief Construct seeded from std::random_device
+	 *
+	 */
+	ParallelRandomStreams() :
+			ParallelRandomStreams(std::random_device()()) {
+	}
+
+	/**@brief Construct with a master seed
+	 *
+	 * @param seed the master seed
+	 * @param chunkSize the number of values per chunk, part of what determines the output so keep it the same to repeat results
+	 */
+	explicit ParallelRandomStreams(uint64_t seed, uint64_t chunkSize = 65536) :
+			seed_(seed), chunkSize_(std::max<uint64_t>(1, chunkSize)) {
+	}
+
+	uint64_t seed_; /**< the master seed */
+	uint64_t chunkSize_; /**< the number of values generated per substream */
+	uint64_t batch_ = 0; /**< the number of calls so far, each call uses new streams */
+
+	/**@brief Run func over the chunks of [0,num), each chunk with its own generator, rethrowing the first exception thrown
+	 *
+	 * @param num the number of values to generate
+	 * @param numThreads the number of threads to use
+	 * @param func called as func(generator_type & gen, uint64_t start, uint64_t len) for each chunk
+	 */
+	template<typename FUNC>
+	void run(uint64_t num, uint32_t numThreads, FUNC func) {
+		const uint64_t nChunks = (num + chunkSize_ - 1) / chunkSize_;
+		if (nChunks > (uint64_t(1) << 32)) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: too many chunks, "
+					+ std::to_string(nChunks) + ", increase chunkSize_" };
+		}
+		const uint64_t streamBase = batch_++ << 32;
+		std::atomic<uint64_t> nextChunk { 0 };
+		std::vector<std::exception_ptr> errors(nChunks);
+		std::function<void()> worker = [&]() {
+			uint64_t chunkPos = nextChunk++;
+			while (chunkPos < nChunks) {
+				try {
+					generator_type gen(seed_, streamBase + chunkPos);
+					const uint64_t start = chunkPos * chunkSize_;
+					func(gen, start, std::min(chunkSize_, num - start));
+				} catch (...) {
+					errors[chunkPos] = std::current_exception();
+				}
+				chunkPos = nextChunk++;
+			}
+		};
+		concurrent::runVoidFunctionThreaded(worker, std::max<uint32_t>(1, std::min<uint64_t>(numThreads, nChunks)));
+		for (const auto & error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	/**@brief Get a vector of doubles in [0,1)
+	 *
+	 * @param num The number of random numbers to generate
+	 * @param numThreads the number of threads to use
+	 * @return A vector of double in [0,1)
+	 */
+	std::vector<double> unifRandVector(uint64_t num, uint32_t numThreads) {
+		std::vector<double> ret(num);
+		run(num, numThreads, [&ret](generator_type & gen, uint64_t start, uint64_t len) {
+			gen.fillUnifRand(ret.data() + start, len);
+		});
+		return ret;
+	}
+
+	/**@brief Get a vector of random numbers in [start,stop)
+	 *
+	 * @param start The start of the range inclusive
+	 * @param stop The end of the range exclusive
+	 * @param num the amount of numbers to generate
+	 * @param numThreads the number of threads to use
+	 * @return A vector of numbers in [start,stop)
+	 */
+	template<typename T>
+	std::vector<T> unifRandVector(T start, T stop, uint64_t num, uint32_t numThreads) {
+		std::vector<T> ret(num);
+		run(num, numThreads, [&ret,start,stop](generator_type & gen, uint64_t chunkStart, uint64_t len) {
+			gen.fillUnifRand(ret.data() + chunkStart, len, start, stop);
+		});
+		return ret;
+	}
+
+	/**@brief Get a vector of normally distributed doubles
+	 *
+	 * @param num the number of values
+	 * @param numThreads the number of threads to use
+	 * @param mean the mean
+	 * @param sd the standard deviation
+	 * @return the values
+	 */
+	std::vector<double> normalVector(uint64_t num, uint32_t numThreads, double mean = 0, double sd = 1) {
+		std::vector<double> ret(num);
+		run(num, numThreads, [&ret,mean,sd](generator_type & gen, uint64_t start, uint64_t len) {
+			gen.fillNormal(ret.data() + start, len, mean, sd);
+		});
+		return ret;
+	}
+};
+
+}  // namespace njh
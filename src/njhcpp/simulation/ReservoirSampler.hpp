@@ -0,0 +1,170 @@
+#pragma once
+/*
+ * ReservoirSampler.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+
+#include "njhcpp/simulation/randomUtils.hpp"
+
+namespace njh {
+
+/**@brief Keep a uniform random sample of a fixed size from a stream of unknown length in one pass
+ *
+ * Uses Li's (1994) Algorithm L which draws how many items to skip before the next one kept, so the random number
+ * generation is logarithmic in the stream length and items that won't be kept aren't copied.
+ *
+ */
+template<typename T, typename ENGINE = std::mt19937_64>
+class ReservoirSampler {
+public:
+	/**@brief Construct with the sample size, seeded from std::random_device
+	 *
+	 * @param sampleSize the number of items to keep
+	 */
+	explicit ReservoirSampler(uint64_t sampleSize) :
+			ReservoirSampler(sampleSize, std::random_device()()) {
+	}
+
+	/**@brief Construct with the sample size and a seed so the sample can be repeated
+	 *
+	 * @param sampleSize the number of items to keep
+	 * @param seed the seed for the generator
+	 */
+	ReservoirSampler(uint64_t sampleSize, uint64_t seed) :
+			sampleSize_(sampleSize), gen_(seed) {
+		if (sampleSize_ > 0) {
+			weight_ = std::exp(std::log(openUnif()) / sampleSize_);
+			nextKept_ = sampleSize_;
+			advanceNextKept();
+		}
+	}
+
+	/**@brief Offer the next item of the stream
+	 *
+	 * @param item the item, only copied if kept
+	 * @return whether the item was kept
+	 */
+	bool add(const T & item) {
+		const int64_t slot = takeSlot();
+		if (slot < 0) {
+			return false;
+		}
+		if (static_cast<uint64_t>(slot) == sample_.size()) {
+			sample_.emplace_back(item);
+		} else {
+			sample_[slot] = item;
+		}
+		return true;
+	}
+
+	/**@brief Offer the next item of the stream
+	 *
+	 * @param item the item, only moved from if kept so a buffer being read into can be passed
+	 * @return whether the item was kept
+	 */
+	bool add(T && item) {
+		const int64_t slot = takeSlot();
+		if (slot < 0) {
+			return false;
+		}
+		if (static_cast<uint64_t>(slot) == sample_.size()) {
+			sample_.emplace_back(std::move(item));
+		} else {
+			sample_[slot] = std::move(item);
+		}
+		return true;
+	}
+
+	/**@brief Whether the next item offered will be kept, for when making the item is expensive and can be skipped
+	 *
+	 * @return true if the next call to add() will keep its item
+	 */
+	bool keepsNext() const {
+		return sample_.size() < sampleSize_ || seen_ + 1 == nextKept_;
+	}
+
+	/**@brief Count an item without offering it, only valid when keepsNext() is false
+	 *
+	 */
+	void skip() {
+		++seen_;
+	}
+
+	/**@brief The current sample, in no particular order
+	 *
+	 * @return the sample, all items if fewer than the sample size have been seen
+	 */
+	const std::vector<T> & sample() const {
+		return sample_;
+	}
+
+	/**@brief Move the sample out, the sampler shouldn't be used afterwards
+	 *
+	 * @return the sample
+	 */
+	std::vector<T> release() {
+		return std::move(sample_);
+	}
+
+	uint64_t sampleSize() const {
+		return sampleSize_;
+	}
+
+	/**@brief The number of items offered so far
+	 *
+	 * @return the number of items seen
+	 */
+	uint64_t seen() const {
+		return seen_;
+	}
+
+private:
+	uint64_t sampleSize_; /**< the number of items to keep */
+	ENGINE gen_; /**< the random generator */
+	std::vector<T> sample_; /**< the sample so far */
+	uint64_t seen_ = 0; /**< the number of items offered */
+	uint64_t nextKept_ = 0; /**< the 1 based position of the next item to keep once the reservoir is full */
+	double weight_ = 0; /**< Algorithm L's W */
+
+	double openUnif() {
+		return toOpenUnitDouble(rand64(gen_));
+	}
+
+	void advanceNextKept() {
+		const double skipped = std::floor(std::log(openUnif()) / std::log1p(-weight_));
+		if (!(skipped < static_cast<double>(std::numeric_limits<uint64_t>::max() - nextKept_ - 1))) {
+			nextKept_ = std::numeric_limits<uint64_t>::max();
+		} else {
+			nextKept_ += static_cast<uint64_t>(skipped) + 1;
+		}
+	}
+
+	/**@brief Count an item and say where it goes
+	 *
+	 * @return the slot in sample_ for the item, -1 if it isn't kept
+	 */
+	int64_t takeSlot() {
+		++seen_;
+		if (sample_.size() < sampleSize_) {
+			return sample_.size();
+		}
+		if (seen_ != nextKept_) {
+			return -1;
+		}
+		const int64_t slot = boundedRand(gen_, sampleSize_);
+		weight_ *= std::exp(std::log(openUnif()) / sampleSize_);
+		advanceNextKept();
+		return slot;
+	}
+};
+
+}  // namespace njh
@@ -0,0 +1,337 @@
+#pragma once
+/*
+ * WeightedSampler.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+
+#include "njhcpp/simulation/randomUtils.hpp"
+
+namespace njh {
+
+/**@brief Walker's alias table, built with Vose's (1991) method, for sampling indexes weighted by fixed weights in constant time
+ *
+ * Each draw takes one 64 bit random number, the high bits of the number times the size pick a column and the low bits decide
+ * between the column and its alias, so the bias is at most size/2^64.
+ * Building is linear in the number of weights, use njh::FenwickSampler if the weights change often.
+ *
+ */
+class AliasTable {
+public:
+	AliasTable() = default;
+
+	/**@brief Build the table
+	 *
+	 * @param weights the weights of each index, can't be negative and at least one has to be positive
+	 */
+	template<typename N>
+	explicit AliasTable(const std::vector<N> & weights) {
+		build(weights);
+	}
+
+	/**@brief Rebuild the table with new weights
+	 *
+	 * @param weights the weights of each index, can't be negative and at least one has to be positive
+	 */
+	template<typename N>
+	void build(const std::vector<N> & weights) {
+		if (weights.empty()) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: weights can't be empty" };
+		}
+		if (weights.size() > std::numeric_limits<uint32_t>::max()) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: too many weights, "
+					+ std::to_string(weights.size()) };
+		}
+		long double total = 0;
+		for (const auto & weight : weights) {
+			const long double w = static_cast<long double>(weight);
+			if (!(w >= 0) || !std::isfinite(w)) {
+				throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: weights have to be finite and not negative" };
+			}
+			total += w;
+		}
+		if (!(total > 0)) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: at least one weight has to be positive" };
+		}
+		const uint32_t n = weights.size();
+		thresholds_.assign(n, std::numeric_limits<uint64_t>::max());
+		aliases_.resize(n);
+		std::vector<long double> scaled(n);
+		std::vector<uint32_t> small;
+		std::vector<uint32_t> large;
+		for (uint32_t pos = 0; pos < n; ++pos) {
+			aliases_[pos] = pos;
+			scaled[pos] = static_cast<long double>(weights[pos]) * n / total;
+			if (scaled[pos] < 1) {
+				small.emplace_back(pos);
+			} else {
+				large.emplace_back(pos);
+			}
+		}
+		while (!small.empty() && !large.empty()) {
+			const uint32_t less = small.back();
+			small.pop_back();
+			const uint32_t more = large.back();
+			thresholds_[less] = toThreshold(scaled[less]);
+			aliases_[less] = more;
+			scaled[more] -= 1 - scaled[less];
+			if (scaled[more] < 1) {
+				large.pop_back();
+				small.emplace_back(more);
+			}
+		}
+		//whatever is left is 1 up to rounding and keeps its own index
+	}
+
+	/**@brief Draw an index
+	 *
+	 * @param gen the random generator
+	 * @return an index with probability weight/total weight
+	 */
+	template<typename URNG>
+	uint32_t operator()(URNG & gen) const {
+		uint64_t coin = 0;
+		const uint32_t column = mulHigh64(rand64(gen), thresholds_.size(), coin);
+		return coin < thresholds_[column] ? column : aliases_[column];
+	}
+
+	/**@brief Fill out with draws
+	 *
+	 * @param gen the random generator
+	 * @param out the buffer to fill
+	 * @param num the number of draws
+	 */
+	template<typename URNG>
+	void fill(URNG & gen, uint32_t * out, size_t num) const {
+		const uint64_t n = thresholds_.size();
+		const uint64_t * thresholds = thresholds_.data();
+		const uint32_t * aliases = aliases_.data();
+		for (size_t pos = 0; pos < num; ++pos) {
+			uint64_t coin = 0;
+			const uint32_t column = mulHigh64(rand64(gen), n, coin);
+			out[pos] = coin < thresholds[column] ? column : aliases[column];
+		}
+	}
+
+	size_t size() const {
+		return thresholds_.size();
+	}
+
+	bool empty() const {
+		return thresholds_.empty();
+	}
+
+private:
+	std::vector<uint64_t> thresholds_; /**< a column keeps its own index when the coin is below this */
+	std::vector<uint32_t> aliases_; /**< the index used for the rest of a column */
+
+	static uint64_t toThreshold(long double prob) {
+		if (prob <= 0) {
+			return 0;
+		}
+		const long double scaled = prob * 18446744073709551616.0L;
+		return scaled >= 18446744073709551615.0L ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(scaled);
+	}
+};
+
+/**@brief Sampling indexes weighted by weights that can be changed, a Fenwick (binary indexed) tree of the weights gives
+ * logarithmic time for both draws and weight updates
+ *
+ * Integer weights are sampled exactly, with floating point weights many updates can build up rounding in the sums
+ * which rebuild() clears.
+ *
+ */
+template<typename W = double>
+class FenwickSampler {
+	static_assert(std::is_arithmetic<W>::value, "FenwickSampler weights have to be arithmetic");
+public:
+	FenwickSampler() :
+			tree_(1, 0) {
+	}
+
+	/**@brief Construct with weights
+	 *
+	 * @param weights the weights of each index, can't be negative
+	 */
+	template<typename N>
+	explicit FenwickSampler(const std::vector<N> & weights) :
+			weights_(weights.begin(), weights.end()) {
+		for (const auto & weight : weights_) {
+			checkWeight(weight, __PRETTY_FUNCTION__);
+		}
+		rebuild();
+	}
+
+	/**@brief Recompute the sums from the current weights, linear time
+	 *
+	 */
+	void rebuild() {
+		tree_.assign(weights_.size() + 1, 0);
+		for (size_t pos = 1; pos <= weights_.size(); ++pos) {
+			tree_[pos] += weights_[pos - 1];
+			const size_t parent = pos + (pos & (0 - pos));
+			if (parent <= weights_.size()) {
+				tree_[parent] += tree_[pos];
+			}
+		}
+		topStep_ = 1;
+		while (topStep_ * 2 <= weights_.size()) {
+			topStep_ *= 2;
+		}
+	}
+
+	/**@brief Add a new index with a weight
+	 *
+	 * @param weight the weight, can't be negative
+	 */
+	void push_back(W weight) {
+		checkWeight(weight, __PRETTY_FUNCTION__);
+		weights_.emplace_back(weight);
+		//a new last node covers the range below it down to its lowest set bit
+		const size_t pos = weights_.size();
+		W sum = weight;
+		for (size_t child = pos - 1, stop = pos - (pos & (0 - pos)); child > stop; child -= child & (0 - child)) {
+			sum += tree_[child];
+		}
+		tree_.emplace_back(sum);
+		if (topStep_ * 2 <= weights_.size()) {
+			topStep_ *= 2;
+		}
+	}
+
+	/**@brief Set the weight of an index
+	 *
+	 * @param pos the index
+	 * @param weight the new weight, can't be negative
+	 */
+	void setWeight(size_t pos, W weight) {
+		checkPos(pos, __PRETTY_FUNCTION__);
+		checkWeight(weight, __PRETTY_FUNCTION__);
+		const W delta = weight - weights_[pos];
+		weights_[pos] = weight;
+		for (size_t node = pos + 1; node < tree_.size(); node += node & (0 - node)) {
+			tree_[node] += delta;
+		}
+	}
+
+	/**@brief Add to the weight of an index
+	 *
+	 * @param pos the index
+	 * @param delta the amount to add, the result can't be negative
+	 */
+	void addWeight(size_t pos, W delta) {
+		checkPos(pos, __PRETTY_FUNCTION__);
+		setWeight(pos, weights_[pos] + delta);
+	}
+
+	W weight(size_t pos) const {
+		return weights_[pos];
+	}
+
+	const std::vector<W> & weights() const {
+		return weights_;
+	}
+
+	/**@brief The sum of the weights of indexes [0,pos)
+	 *
+	 * @param pos the end of the range
+	 * @return the sum
+	 */
+	W prefixSum(size_t pos) const {
+		W ret = 0;
+		for (; pos > 0; pos -= pos & (0 - pos)) {
+			ret += tree_[pos];
+		}
+		return ret;
+	}
+
+	W total() const {
+		return prefixSum(weights_.size());
+	}
+
+	size_t size() const {
+		return weights_.size();
+	}
+
+	bool empty() const {
+		return weights_.empty();
+	}
+
+	/**@brief Draw an index
+	 *
+	 * @param gen the random generator
+	 * @return an index with probability weight/total weight
+	 */
+	template<typename URNG>
+	size_t operator()(URNG & gen) const {
+		const W sum = total();
+		if (!(sum > 0)) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: the total weight has to be positive" };
+		}
+		W target;
+		if constexpr (std::is_integral<W>::value) {
+			target = static_cast<W>(boundedRand(gen, static_cast<uint64_t>(sum)));
+		} else {
+			target = static_cast<W>(toUnitDouble(rand64(gen)) * sum);
+		}
+		return find(target);
+	}
+
+	/**@brief Find the index whose cumulative weight range contains target
+	 *
+	 * @param target a number in [0,total())
+	 * @return the first index where the sum of weights up to and including it is greater than target
+	 */
+	size_t find(W target) const {
+		size_t pos = 0;
+		for (size_t step = weights_.empty() ? 0 : topStep_; step > 0; step >>= 1) {
+			if (pos + step < tree_.size() && tree_[pos + step] <= target) {
+				pos += step;
+				target -= tree_[pos];
+			}
+		}
+		if constexpr (!std::is_integral<W>::value) {
+			//rounding can land past the end or on an empty weight at a boundary
+			if (pos >= weights_.size()) {
+				pos = weights_.size() - 1;
+			}
+			while (pos > 0 && !(weights_[pos] > 0)) {
+				--pos;
+			}
+			while (pos + 1 < weights_.size() && !(weights_[pos] > 0)) {
+				++pos;
+			}
+		}
+		return pos;
+	}
+
+private:
+	std::vector<W> weights_; /**< the weight of each index */
+	std::vector<W> tree_; /**< 1 based Fenwick tree of the weights */
+	size_t topStep_ = 1; /**< the highest power of 2 not above the size, where the descent in find() starts */
+
+	static void checkWeight(W weight, const char * funcName) {
+		if (!(weight >= 0) || !std::isfinite(static_cast<long double>(weight))) {
+			throw std::runtime_error { std::string(funcName) + ", error: weights have to be finite and not negative" };
+		}
+	}
+
+	void checkPos(size_t pos, const char * funcName) const {
+		if (pos >= weights_.size()) {
+			throw std::out_of_range { std::string(funcName) + ", error: position " + std::to_string(pos)
+					+ " is out of range, size is " + std::to_string(weights_.size()) };
+		}
+	}
+};
+
+}  // namespace njh
@@ -8,6 +8,8 @@
 
 #include <cppitertools/range.hpp>
 #include "njhcpp/simulation/randomGenerator.hpp"
+#include "njhcpp/simulation/WeightedSampler.hpp"
+#include "njhcpp/simulation/ParallelRandomStreams.hpp"
 #include "njhcpp/common/misc.hpp"
 #include <map>
 #include <iostream>
@@ -16,6 +18,10 @@
 namespace njh {
 
 /**@brief class for generating a random object from a given vector of objects weighting for their given counts
+ *
+ * Objects are drawn from an alias table (njh::AliasTable) so each draw is constant time no matter the number of objects,
+ * use njh::dynamicRandObjectGen if the counts need to change between draws. The table is built on the first draw, so constructing
+ * with no objects or all zero counts is still fine but drawing from them throws
  *
  */
 template<typename T, typename N>
@@ -29,7 +35,7 @@ public:
 	objs_(objs), objCounts_(std::vector<N>(objs.size(),1)),
 	likelihoods_(createLikelihood(objs_,objCounts_)){
 		std::random_device rd;
-		mtGen_.seed(rd());
+		seedNum(rd());
 	}
 	/**@brief Set up for generating objects weighting for their counts
 	 *
@@ -41,7 +47,7 @@ public:
 					objs_(objs), objCounts_(counts),
 	likelihoods_(createLikelihood(objs_, objCounts_)){
 		std::random_device rd;
-		mtGen_.seed(rd());
+		seedNum(rd());
 	}
 private:
 	/**@brief random generator for numbers
@@ -60,9 +66,47 @@ private:
 	 *
 	 */
 	std::multimap<uint64_t, T, std::less<uint64_t>> likelihoods_;
+	/**@brief the alias table of objCounts_ used to pick the index of the object to generate, built by aliasTable() on the first draw
+	 *
+	 */
+	AliasTable aliasTable_;
+	bool aliasTableBuilt_ = false;
+
+	/**@brief the alias table, building it if this is the first draw
+	 *
+	 * @return the alias table, throws if there are no objects or no positive counts
+	 */
+	const AliasTable & aliasTable(){
+		if(!aliasTableBuilt_){
+			aliasTable_ = AliasTable(objCounts_);
+			aliasTableBuilt_ = true;
+		}
+		return aliasTable_;
+	}
+	/**@brief substreams of the seed for genObjsParallel()
+	 *
+	 */
+	ParallelRandomStreams<> parallelStreams_{0};
 
 public:
 
+	/**@brief seed the generator so the objects generated can be repeated, also reseeds the streams used by genObjsParallel()
+	 *
+	 * @param givenSeed the seed
+	 */
+	void seedNum(uint64_t givenSeed){
+		mtGen_.seed(givenSeed);
+		parallelStreams_ = ParallelRandomStreams<>(givenSeed);
+	}
+
+	/**@brief the current seed
+	 *
+	 * @return the seed last given to seedNum()
+	 */
+	uint64_t currentSeed() const{
+		return parallelStreams_.seed_;
+	}
+
 	/**@brief get const reference to objs
 	 *
 	 * @return a const reference to objs
@@ -93,15 +137,7 @@ public:
 	 * @return A random object
 	 */
 	T genObj(){
-	  uint64_t sum = 0;
-	  uint64_t rando = mtGen_();
-	  for (const auto &likelihood : likelihoods_) {
-	    sum += likelihood.first;
-	    if (sum > rando) {
-	      return likelihood.second;
-	    }
-	  }
-	  return likelihoods_.rbegin()->second;
+		return objs_[aliasTable()(mtGen_)];
 	}
 	/**@brief generated a given number of objects with replacement
 	 *
@@ -109,8 +145,55 @@ public:
 	 * @return The randomly generated objects
 	 */
 	std::vector<T> genObjs(uint32_t num){
-		std::vector<T> ans(num);
-		std::generate_n(ans.begin(), num, [&]() { return genObj();});
+		std::vector<T> ans;
+		ans.reserve(num);
+		genObjs(num, ans);
+		return ans;
+	}
+	/**@brief generated a given number of objects with replacement and append them to out, so a buffer can be reused
+	 *
+	 * @param num The number of objects to generate
+	 * @param out The vector to append the objects to
+	 */
+	void genObjs(uint32_t num, std::vector<T> & out){
+		std::vector<uint32_t> indexes(num);
+		aliasTable().fill(mtGen_, indexes.data(), num);
+		out.reserve(out.size() + num);
+		for (const auto idx : indexes) {
+			out.emplace_back(objs_[idx]);
+		}
+	}
+	/**@brief generated a given number of objects with replacement over several threads
+	 *
+	 * The objects come from substreams of the seed (see njh::ParallelRandomStreams) so are the same for a seed no matter numThreads,
+	 * they aren't the same objects as genObjs() gives and don't advance the generator genObj() uses
+	 *
+	 * @param num The number of objects to generate
+	 * @param numThreads The number of threads to use
+	 * @return The randomly generated objects
+	 */
+	std::vector<T> genObjsParallel(uint64_t num, uint32_t numThreads){
+		std::vector<uint32_t> indexes(num);
+		const AliasTable & table = aliasTable();
+		parallelStreams_.run(num, numThreads,
+				[&table,&indexes](ParallelRandomStreams<>::generator_type & gen, uint64_t start, uint64_t len){
+			table.fill(gen.mtGen_, indexes.data() + start, len);
+		});
+		std::vector<T> ans;
+		ans.reserve(num);
+		for (const auto idx : indexes) {
+			ans.emplace_back(objs_[idx]);
+		}
+		return ans;
+	}
+	/**@brief generated a given number of object indexes (positions in objs()) with replacement
+	 *
+	 * @param num The number of indexes to generate
+	 * @return The randomly generated indexes
+	 */
+	std::vector<uint32_t> genObjIndexes(uint32_t num){
+		std::vector<uint32_t> ans(num);
+		aliasTable().fill(mtGen_, ans.data(), num);
 		return ans;
 	}
 	/**@brief function for generated the likihood map that is used to generate the random objects
@@ -141,6 +224,122 @@ public:
 
 
 
+/**@brief class for generating random objects weighting for counts that can be changed between draws
+ *
+ * The counts are kept in a Fenwick tree (njh::FenwickSampler) so draws and count updates are both logarithmic in the number of objects
+ *
+ */
+template<typename T, typename N>
+class dynamicRandObjectGen {
+public:
+	/**@brief Set up for generating objects weighting for their counts
+	 *
+	 * @param objs The vector of objects to be generating
+	 * @param counts The counts of the objects given, should be the same length as objects
+	 */
+	dynamicRandObjectGen(const std::vector<T> & objs,
+			const std::vector<N> & counts):
+					objs_(objs), sampler_(counts){
+		if (counts.size() != objs.size()) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error " << "size of counts differs from size of input objects, counts: "
+					<< counts.size() << ", objs: " << objs.size() << std::endl;
+			throw std::runtime_error{ss.str()};
+		}
+		std::random_device rd;
+		mtGen_.seed(rd());
+	}
+private:
+	/**@brief random generator for numbers
+	 *
+	 */
+	std::mt19937_64 mtGen_;
+	/**@brief the objects to be generated
+	 *
+	 */
+	std::vector<T> objs_;
+	/**@brief the counts of the objects
+	 *
+	 */
+	FenwickSampler<N> sampler_;
+
+public:
+
+	const std::vector<T> & objs() const{
+		return objs_;
+	}
+
+	const std::vector<N> & objCounts() const{
+		return sampler_.weights();
+	}
+
+	/**@brief seed the generator so the objects generated can be repeated
+	 *
+	 * @param givenSeed the seed
+	 */
+	void seedNum(uint64_t givenSeed){
+		mtGen_.seed(givenSeed);
+	}
+
+	/**@brief Set the count of the object at pos
+	 *
+	 * @param pos the position of the object in objs()
+	 * @param count the new count, can't be negative
+	 */
+	void setObjCount(size_t pos, N count){
+		sampler_.setWeight(pos, count);
+	}
+
+	/**@brief Add to the count of the object at pos, e.g. -1 to draw without replacement
+	 *
+	 * @param pos the position of the object in objs()
+	 * @param delta the amount to add, the new count can't be negative
+	 */
+	void addObjCount(size_t pos, N delta){
+		sampler_.addWeight(pos, delta);
+	}
+
+	/**@brief Add a new object
+	 *
+	 * @param obj the object
+	 * @param count its count
+	 */
+	void addObj(const T & obj, N count){
+		sampler_.push_back(count);
+		objs_.emplace_back(obj);
+	}
+
+	/**@brief return the position in objs() of a random object weighting for counts
+	 *
+	 * @return the position of a random object
+	 */
+	size_t genObjIndex(){
+		return sampler_(mtGen_);
+	}
+
+	/**@brief return a random objects weighting for counts
+	 *
+	 * @return A random object
+	 */
+	T genObj(){
+		return objs_[sampler_(mtGen_)];
+	}
+
+	/**@brief generated a given number of objects with replacement
+	 *
+	 * @param num The number of objects to generate
+	 * @return The randomly generated objects
+	 */
+	std::vector<T> genObjs(uint32_t num){
+		std::vector<T> ans;
+		ans.reserve(num);
+		for (uint32_t count = 0; count < num; ++count) {
+			ans.emplace_back(objs_[sampler_(mtGen_)]);
+		}
+		return ans;
+	}
+};
+
 } /* namespace njh */
 
 
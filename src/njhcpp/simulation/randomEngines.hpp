@@ -0,0 +1,384 @@
+#pragma once
+/*
+ * randomEngines.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+
+#include "njhcpp/simulation/randomUtils.hpp"
+
+namespace njh {
+
+/**@brief xoshiro256** (Blackman and Vigna 2018), a small (32 byte state) and fast 64 bit generator with period 2^256 - 1
+ *
+ * Meets the standard UniformRandomBitGenerator requirements so it can be used with std distributions and algorithms.
+ * Streams are made with jump() which advances 2^128 draws, so streams never overlap, but a stream id costs that many jumps.
+ *
+ */
+class Xoshiro256ss {
+public:
+	typedef uint64_t result_type;
+
+	static constexpr result_type min() {
+		return 0;
+	}
+	static constexpr result_type max() {
+		return std::numeric_limits<result_type>::max();
+	}
+
+	/**@brief Construct seeded with seed
+	 *
+	 * @param seed the seed, expanded into the state with SplitMix64
+	 */
+	explicit Xoshiro256ss(uint64_t seed = 0) {
+		this->seed(seed);
+	}
+
+	/**@brief Construct with a seed and a stream, see seedStream()
+	 *
+	 * @param seed the seed
+	 * @param stream the stream
+	 */
+	Xoshiro256ss(uint64_t seed, uint64_t stream) {
+		seedStream(seed, stream);
+	}
+
+	void seed(uint64_t seed) {
+		uint64_t mixer = seed;
+		for (auto & word : state_) {
+			word = splitMix64(mixer);
+		}
+	}
+
+	/**@brief Seed and then jump() stream times so that each stream is 2^128 draws apart
+	 *
+	 * @param seed the seed
+	 * @param stream the stream, cost is linear in this
+	 */
+	void seedStream(uint64_t seed, uint64_t stream) {
+		this->seed(seed);
+		for (uint64_t count = 0; count < stream; ++count) {
+			jump();
+		}
+	}
+
+	result_type operator()() {
+		const uint64_t ret = rotl(state_[1] * 5, 7) * 9;
+		const uint64_t shifted = state_[1] << 17;
+		state_[2] ^= state_[0];
+		state_[3] ^= state_[1];
+		state_[1] ^= state_[2];
+		state_[0] ^= state_[3];
+		state_[2] ^= shifted;
+		state_[3] = rotl(state_[3], 45);
+		return ret;
+	}
+
+	void discard(uint64_t num) {
+		for (uint64_t count = 0; count < num; ++count) {
+			(*this)();
+		}
+	}
+
+	/**@brief Advance the same as 2^128 draws
+	 *
+	 */
+	void jump() {
+		jumpBy( { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL });
+	}
+
+	/**@brief Advance the same as 2^192 draws
+	 *
+	 */
+	void longJump() {
+		jumpBy( { 0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL });
+	}
+
+	const std::array<uint64_t, 4> & state() const {
+		return state_;
+	}
+
+	void setState(const std::array<uint64_t, 4> & state) {
+		state_ = state;
+	}
+
+	bool operator==(const Xoshiro256ss & other) const {
+		return state_ == other.state_;
+	}
+	bool operator!=(const Xoshiro256ss & other) const {
+		return !(*this == other);
+	}
+
+private:
+	std::array<uint64_t, 4> state_; /**< should never be all zeros */
+
+	static uint64_t rotl(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+	void jumpBy(const std::array<uint64_t, 4> & poly) {
+		std::array<uint64_t, 4> jumped { 0, 0, 0, 0 };
+		for (const auto word : poly) {
+			for (uint32_t bit = 0; bit < 64; ++bit) {
+				if (word & (uint64_t(1) << bit)) {
+					for (uint32_t pos = 0; pos < 4; ++pos) {
+						jumped[pos] ^= state_[pos];
+					}
+				}
+				(*this)();
+			}
+		}
+		state_ = jumped;
+	}
+};
+
+#if defined(__SIZEOF_INT128__)
+/**@brief PCG64 (O'Neill 2014), the XSL RR output on a 128 bit linear congruential generator, period 2^128 per stream and 2^127 streams
+ *
+ * Streams pick the LCG increment so seeding a stream is constant time, advance() jumps ahead any number of draws in logarithmic time.
+ * Outputs match the reference pcg64 (pcg_setseq_128_xsl_rr_64) for the same seed and stream.
+ *
+ */
+class Pcg64 {
+public:
+	typedef uint64_t result_type;
+
+	static constexpr result_type min() {
+		return 0;
+	}
+	static constexpr result_type max() {
+		return std::numeric_limits<result_type>::max();
+	}
+
+	explicit Pcg64(uint64_t seed = 0) {
+		this->seed(seed);
+	}
+
+	Pcg64(uint64_t seed, uint64_t stream) {
+		seedStream(seed, stream);
+	}
+
+	void seed(uint64_t seed) {
+		seedStream(seed, 0);
+	}
+
+	/**@brief Seed with a seed and a stream, the same seed on different streams gives independent sequences
+	 *
+	 * @param seed the seed (initial state)
+	 * @param stream the stream (selects the increment)
+	 */
+	void seedStream(uint64_t seed, uint64_t stream) {
+		inc_ = (static_cast<uint128>(stream) << 1) | 1;
+		state_ = 0;
+		step();
+		state_ += seed;
+		step();
+	}
+
+	result_type operator()() {
+		step();
+		const uint64_t xored = static_cast<uint64_t>(state_ >> 64) ^ static_cast<uint64_t>(state_);
+		const uint32_t rot = static_cast<uint32_t>(state_ >> 122);
+		return (xored >> rot) | (xored << ((0 - rot) & 63));
+	}
+
+	/**@brief Jump ahead delta draws
+	 *
+	 * @param delta the number of draws to skip
+	 */
+	void advance(uint64_t delta) {
+		uint128 accMult = 1;
+		uint128 accPlus = 0;
+		uint128 curMult = multiplier();
+		uint128 curPlus = inc_;
+		while (delta > 0) {
+			if (delta & 1) {
+				accMult *= curMult;
+				accPlus = accPlus * curMult + curPlus;
+			}
+			curPlus = (curMult + 1) * curPlus;
+			curMult *= curMult;
+			delta >>= 1;
+		}
+		state_ = accMult * state_ + accPlus;
+	}
+
+	void discard(uint64_t num) {
+		advance(num);
+	}
+
+	bool operator==(const Pcg64 & other) const {
+		return state_ == other.state_ && inc_ == other.inc_;
+	}
+	bool operator!=(const Pcg64 & other) const {
+		return !(*this == other);
+	}
+
+private:
+	typedef unsigned __int128 uint128;
+	uint128 state_ = 0; /**< the LCG state */
+	uint128 inc_ = 1; /**< the LCG increment, always odd */
+
+	static constexpr uint128 multiplier() {
+		return (static_cast<uint128>(2549297995355413924ULL) << 64) + 4865540595714422341ULL;
+	}
+
+	void step() {
+		state_ = state_ * multiplier() + inc_;
+	}
+};
+#endif
+
+/**@brief Philox4x64-10 (Salmon et al. 2011), a counter-based generator, each block of four outputs is a keyed bijection of a counter
+ *
+ * Any position of any stream can be reached in constant time, the key is the seed and the stream so
+ * streams are independent by construction, which makes it the engine to use for many reproducible parallel streams.
+ * Outputs match the Random123 philox4x64 known answers with key {seed, stream} and counter {block, 0, 0, 0}.
+ *
+ */
+class Philox4x64 {
+public:
+	typedef uint64_t result_type;
+
+	static constexpr result_type min() {
+		return 0;
+	}
+	static constexpr result_type max() {
+		return std::numeric_limits<result_type>::max();
+	}
+
+	explicit Philox4x64(uint64_t seed = 0) {
+		this->seed(seed);
+	}
+
+	Philox4x64(uint64_t seed, uint64_t stream) {
+		seedStream(seed, stream);
+	}
+
+	void seed(uint64_t seed) {
+		seedStream(seed, 0);
+	}
+
+	/**@brief Set the key to seed and stream and go back to the start of the stream
+	 *
+	 * @param seed the seed
+	 * @param stream the stream
+	 */
+	void seedStream(uint64_t seed, uint64_t stream) {
+		key_ = { seed, stream };
+		counter_ = { 0, 0, 0, 0 };
+		bufferPos_ = 4;
+	}
+
+	result_type operator()() {
+		if (4 == bufferPos_) {
+			buffer_ = block(counter_, key_);
+			incrementCounter(1);
+			bufferPos_ = 0;
+		}
+		return buffer_[bufferPos_++];
+	}
+
+	/**@brief Skip num draws, constant time
+	 *
+	 * @param num the number of draws to skip
+	 */
+	void discard(uint64_t num) {
+		const uint64_t available = 4 - bufferPos_;
+		if (num < available) {
+			bufferPos_ += num;
+			return;
+		}
+		num -= available;
+		incrementCounter(num / 4);
+		bufferPos_ = 4;
+		if (num % 4 > 0) {
+			(*this)();
+			bufferPos_ = num % 4;
+		}
+	}
+
+	/**@brief The Philox4x64-10 bijection
+	 *
+	 * @param counter the counter
+	 * @param key the key
+	 * @return four random 64 bit numbers
+	 */
+	static std::array<uint64_t, 4> block(std::array<uint64_t, 4> counter, std::array<uint64_t, 2> key) {
+		for (uint32_t round = 0; round < 10; ++round) {
+			if (round > 0) {
+				key[0] += 0x9E3779B97F4A7C15ULL;
+				key[1] += 0xBB67AE8584CAA73BULL;
+			}
+			uint64_t low0 = 0;
+			uint64_t low1 = 0;
+			const uint64_t high0 = mulHigh64(0xD2E7470EE14C6C93ULL, counter[0], low0);
+			const uint64_t high1 = mulHigh64(0xCA5A826395121157ULL, counter[2], low1);
+			counter = { high1 ^ counter[1] ^ key[0], low1, high0 ^ counter[3] ^ key[1], low0 };
+		}
+		return counter;
+	}
+
+	bool operator==(const Philox4x64 & other) const {
+		return key_ == other.key_ && counter_ == other.counter_ && bufferPos_ == other.bufferPos_;
+	}
+	bool operator!=(const Philox4x64 & other) const {
+		return !(*this == other);
+	}
+
+private:
+	std::array<uint64_t, 2> key_; /**< the seed and the stream */
+	std::array<uint64_t, 4> counter_; /**< the next block, a 128 bit count in the first two words */
+	std::array<uint64_t, 4> buffer_ { 0, 0, 0, 0 }; /**< the current block of outputs */
+	uint32_t bufferPos_ = 4; /**< the next output in buffer_, 4 when it's used up */
+
+	void incrementCounter(uint64_t num) {
+		const uint64_t before = counter_[0];
+		counter_[0] += num;
+		if (counter_[0] < before) {
+			++counter_[1];
+		}
+	}
+};
+
+namespace impl {
+template<typename ENGINE, typename = void>
+struct hasSeedStream : std::false_type {
+};
+template<typename ENGINE>
+struct hasSeedStream<ENGINE,
+		std::void_t<decltype(std::declval<ENGINE &>().seedStream(uint64_t(), uint64_t()))>> : std::true_type {
+};
+}  // namespace impl
+
+/**@brief Seed an engine for one stream of a seed, engines with a seedStream() (the njh engines) use it, standard engines
+ * are seeded with a std::seed_seq of the seed and stream, stream 0 is always the same as seeding with just the seed
+ *
+ * @param engine the engine to seed
+ * @param seed the seed
+ * @param stream the stream
+ */
+template<typename ENGINE>
+void seedEngineStream(ENGINE & engine, uint64_t seed, uint64_t stream) {
+	if constexpr (impl::hasSeedStream<ENGINE>::value) {
+		engine.seedStream(seed, stream);
+	} else {
+		if (0 == stream) {
+			engine.seed(seed);
+		} else {
+			std::seed_seq seq { static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+					static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) };
+			engine.seed(seq);
+		}
+	}
+}
+
+}  // namespace njh
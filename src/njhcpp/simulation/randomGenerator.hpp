@@ -8,43 +8,68 @@
 
 #include <random>
 #include <sstream>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <unordered_set>
+#include <numeric>
 #include "njhcpp/common.h"
 #include "njhcpp/utils/vecUtils.hpp"
+#include "njhcpp/simulation/randomUtils.hpp"
+#include "njhcpp/simulation/randomEngines.hpp"
 
 namespace njh {
-/**@brief A random generator class that basically just wraps std::mt19937_64 to make generation or random selections a bit easier
+/**@brief A random generator class that wraps a random engine (std::mt19937_64 for njh::randomGenerator) to make generation or random selections a bit easier
+ *
+ * ENGINE can be any standard UniformRandomBitGenerator that can be seeded with a uint64_t, e.g. the smaller and faster
+ * njh::Xoshiro256ss, njh::Pcg64 or the counter-based njh::Philox4x64 (see njh::fastRandomGenerator and njh::parallelRandomGenerator).
+ * A seed and a stream number give a reproducible sequence, split() gives generators for other streams of the same seed e.g. one per thread.
  *
  */
-class randomGenerator {
+template<typename ENGINE>
+class randomGeneratorT {
 
 public:
-	/**@brief default constructor seeds the std::mt19937_64 with a seed from std::random_device
+	typedef ENGINE engine_type;
+	/**@brief default constructor seeds the engine with a seed from std::random_device
 	 *
 	 */
-	randomGenerator() {
+	randomGeneratorT() {
 		seed();
 	}
 	/**@brief constructor with a specific seed so you can repeat random generations
 	 *
 	 * @param givenSeed
 	 */
-	randomGenerator(uint64_t givenSeed) {
+	randomGeneratorT(uint64_t givenSeed) {
 		seedNum(givenSeed);
 	}
-	/**@brief the main work horse of the class that generators the base random numbers needed
+	/**@brief constructor with a specific seed and stream, different streams of the same seed give independent sequences
+	 *
+	 * @param givenSeed the seed
+	 * @param stream the stream
+	 */
+	randomGeneratorT(uint64_t givenSeed, uint64_t stream) {
+		seedNum(givenSeed, stream);
+	}
+	/**@brief the main work horse of the class that generators the base random numbers needed, named for the original std::mt19937_64
 	 *
 	 */
-	std::mt19937_64 mtGen_;
+	ENGINE mtGen_;
 	/**@brief the current seed being used for the state of mtGen_
 	 *
 	 */
 	uint64_t currentSeed_;
+	/**@brief the current stream of currentSeed_ being used
+	 *
+	 */
+	uint64_t currentStream_ = 0;
 	/**@brief Generator a random nuber between 0 and 1 in the range [0,1)
 	 *
 	 * @return a double in [0,1)
 	 */
 	double unifRand() {
-		return mtGen_() / (static_cast<double>(mtGen_.max()) + 1);
+		return toUnitDouble(rand64(mtGen_));
 	}
 	/**@brief Calls unifRand() so you don't have to type the whole thing
 	 *
@@ -61,11 +86,10 @@ public:
 	 */
 	std::vector<double> unifRandVector(uint32_t num) {
 		std::vector<double> ret(num);
-		std::generate(ret.begin(), ret.end(), [&]() {
-			return unifRand();});
+		fillUnifRand(ret.data(), ret.size());
 		return ret;
 	}
-	/**@brief Generator numbers in [start,stop), templated so integers or double can be used
+	/**@brief Generator numbers in [start,stop), templated so integers or double can be used, integers are unbiased (Lemire's multiply and shift)
 	 *
 	 * @param start The start of the range inclusive
 	 * @param stop The end of the range, exclusive
@@ -73,7 +97,54 @@ public:
 	 */
 	template<typename T>
 	T unifRand(T start, T stop) {
-		return static_cast<T>((stop - start) * unifRand()) + start;
+		if constexpr (std::is_integral<T>::value) {
+			return static_cast<T>(start + boundedRand(mtGen_, intRange(start, stop)));
+		} else {
+			return static_cast<T>((stop - start) * unifRand()) + start;
+		}
+	}
+	/**@brief Fill a buffer with doubles in [start,stop), the same numbers as calling unifRand(start, stop) num times
+	 *
+	 * The engine output is drawn in blocks and then converted in a separate loop the compiler can vectorize
+	 *
+	 * @param out the buffer to fill
+	 * @param num the number of values
+	 * @param start The start of the range inclusive
+	 * @param stop The end of the range exclusive
+	 */
+	void fillUnifRand(double * out, size_t num, double start = 0, double stop = 1) {
+		const double scale = (stop - start) * 0x1.0p-53;
+		std::array<uint64_t, batchSize_> bits;
+		for (size_t pos = 0; pos < num; pos += batchSize_) {
+			const size_t batchNum = std::min(batchSize_, num - pos);
+			for (size_t idx = 0; idx < batchNum; ++idx) {
+				bits[idx] = rand64(mtGen_);
+			}
+			double * batchOut = out + pos;
+			for (size_t idx = 0; idx < batchNum; ++idx) {
+				batchOut[idx] = static_cast<double>(bits[idx] >> 11) * scale + start;
+			}
+		}
+	}
+	/**@brief Fill a buffer with numbers in [start,stop), the same numbers as calling unifRand(start, stop) num times
+	 *
+	 * @param out the buffer to fill
+	 * @param num the number of values
+	 * @param start The start of the range inclusive
+	 * @param stop The end of the range exclusive
+	 */
+	template<typename T>
+	void fillUnifRand(T * out, size_t num, T start, T stop) {
+		if constexpr (std::is_integral<T>::value) {
+			const uint64_t range = intRange(start, stop);
+			for (size_t pos = 0; pos < num; ++pos) {
+				out[pos] = static_cast<T>(start + boundedRand(mtGen_, range));
+			}
+		} else {
+			for (size_t pos = 0; pos < num; ++pos) {
+				out[pos] = unifRand(start, stop);
+			}
+		}
 	}
 	/**@brief Get a vector of random numbers in [start,stop)
 	 *
@@ -85,7 +156,7 @@ public:
 	template<typename T>
 	std::vector<T> unifRandVector(T start, T stop, int num) {
 		std::vector<T> ret(num);
-		std::generate_n(ret.begin(), num, [&]() {return unifRand(start, stop);});
+		fillUnifRand(ret.data(), ret.size(), start, stop);
 		return ret;
 	}
 	/**@brief A vector of vectors of random numbers in [start,stop)
@@ -99,9 +170,118 @@ public:
 	template<typename T>
 	std::vector<std::vector<T>> unifRandVecVec(T start, T stop, uint32_t totalNum,
 			uint32_t subNum) {
-		std::vector<std::vector<T>> ret(totalNum);
-		std::generate(ret.begin(), ret.end(),
-				[&]() {return unifRandVector<T>(start,stop,subNum);});
+		std::vector<std::vector<T>> ret;
+		ret.reserve(totalNum);
+		for (uint32_t row = 0; row < totalNum; ++row) {
+			ret.emplace_back(subNum);
+			fillUnifRand(ret.back().data(), subNum, start, stop);
+		}
+		return ret;
+	}
+	/**@brief A row major matrix of random numbers in [start,stop) in one contiguous buffer, the same numbers as unifRandVecVec()
+	 *
+	 * @param start The start of the range inclusive
+	 * @param stop The end of the range exclusive
+	 * @param nRows the number of rows
+	 * @param nCols the number of columns
+	 * @return the matrix, element (row, col) is at row * nCols + col
+	 */
+	template<typename T>
+	std::vector<T> unifRandMatrix(T start, T stop, uint32_t nRows, uint32_t nCols) {
+		std::vector<T> ret(static_cast<size_t>(nRows) * nCols);
+		fillUnifRand(ret.data(), ret.size(), start, stop);
+		return ret;
+	}
+	/**@brief Fill a buffer with normally distributed doubles, by the Box-Muller transform so two values per pair of draws
+	 *
+	 * @param out the buffer to fill
+	 * @param num the number of values
+	 * @param mean the mean
+	 * @param sd the standard deviation
+	 */
+	void fillNormal(double * out, size_t num, double mean = 0, double sd = 1) {
+		constexpr double twoPi = 6.283185307179586476925286766559;
+		std::array<double, batchSize_> unifs;
+		for (size_t pos = 0; pos < num; pos += batchSize_) {
+			const size_t batchNum = std::min(batchSize_, num - pos);
+			const size_t pairs = (batchNum + 1) / 2;
+			fillUnifRand(unifs.data(), 2 * pairs);
+			double * batchOut = out + pos;
+			for (size_t pair = 0; pair < batchNum / 2; ++pair) {
+				//1 - u is in (0,1] so the log is finite
+				const double radius = sd * std::sqrt(-2 * std::log(1 - unifs[2 * pair]));
+				const double theta = twoPi * unifs[2 * pair + 1];
+				batchOut[2 * pair] = mean + radius * std::cos(theta);
+				batchOut[2 * pair + 1] = mean + radius * std::sin(theta);
+			}
+			if (batchNum % 2 == 1) {
+				const double radius = sd * std::sqrt(-2 * std::log(1 - unifs[batchNum - 1]));
+				batchOut[batchNum - 1] = mean + radius * std::cos(twoPi * unifs[batchNum]);
+			}
+		}
+	}
+	/**@brief Get a vector of normally distributed doubles
+	 *
+	 * @param num the number of values
+	 * @param mean the mean
+	 * @param sd the standard deviation
+	 * @return the values
+	 */
+	std::vector<double> normalVector(uint32_t num, double mean = 0, double sd = 1) {
+		std::vector<double> ret(num);
+		fillNormal(ret.data(), ret.size(), mean, sd);
+		return ret;
+	}
+	/**@brief Fill a buffer with Poisson distributed counts, one distribution set up for the whole buffer
+	 *
+	 * @param out the buffer to fill
+	 * @param num the number of values
+	 * @param mean the mean of the distribution
+	 */
+	template<typename T>
+	void fillPoisson(T * out, size_t num, double mean) {
+		std::poisson_distribution<T> dist(mean);
+		for (size_t pos = 0; pos < num; ++pos) {
+			out[pos] = dist(mtGen_);
+		}
+	}
+	/**@brief Get a vector of Poisson distributed counts
+	 *
+	 * @param num the number of values
+	 * @param mean the mean of the distribution
+	 * @return the values
+	 */
+	template<typename T = uint32_t>
+	std::vector<T> poissonVector(uint32_t num, double mean) {
+		std::vector<T> ret(num);
+		fillPoisson(ret.data(), ret.size(), mean);
+		return ret;
+	}
+	/**@brief Fill a buffer with binomially distributed counts, one distribution set up for the whole buffer
+	 *
+	 * @param out the buffer to fill
+	 * @param num the number of values
+	 * @param trials the number of trials
+	 * @param prob the probability of success of each trial
+	 */
+	template<typename T>
+	void fillBinomial(T * out, size_t num, T trials, double prob) {
+		std::binomial_distribution<T> dist(trials, prob);
+		for (size_t pos = 0; pos < num; ++pos) {
+			out[pos] = dist(mtGen_);
+		}
+	}
+	/**@brief Get a vector of binomially distributed counts
+	 *
+	 * @param num the number of values
+	 * @param trials the number of trials
+	 * @param prob the probability of success of each trial
+	 * @return the values
+	 */
+	template<typename T = uint32_t>
+	std::vector<T> binomialVector(uint32_t num, T trials, double prob) {
+		std::vector<T> ret(num);
+		fillBinomial(ret.data(), ret.size(), trials, prob);
 		return ret;
 	}
 	/**@brief Get a random selection from a vector of objects
@@ -124,27 +304,73 @@ public:
 	std::vector<T> unifRandSelectionVec(const std::vector<T> & vec, uint32_t amt,
 			bool withReplacement) {
 		std::vector<T> ret;
-		std::vector<uint32_t> rSel;
+		ret.reserve(amt);
 		if (withReplacement) {
-			rSel = unifRandVector<uint32_t>(0, vec.size(), amt);
+			for (const auto & pos : unifRandVector<uint64_t>(0, vec.size(), amt)) {
+				ret.emplace_back(vec[pos]);
+			}
 		} else {
 			if (amt > vec.size()) {
 				std::stringstream ss;
 				ss << "Error in unifRandSelectionVec, requesting"
 						" more than is in vec but said without replacement" << std::endl;
 				throw std::runtime_error { ss.str() };
-			} else {
-				std::vector<uint32_t> rSelPos(vec.size());
-				iota<uint32_t>(rSelPos, 0);
-				shuffle(rSelPos, mtGen_);
-				rSel = getSubVector(rSelPos, 0, amt);
+			}
+			for (const auto & pos : unifRandIndexes(vec.size(), amt)) {
+				ret.emplace_back(vec[pos]);
 			}
 		}
-		for (const auto & pos : rSel) {
-			ret.emplace_back(vec[pos]);
+		return ret;
+	}
+	/**@brief Get amt distinct indexes in [0,total) in random order
+	 *
+	 * Small samples use Floyd's algorithm so take time and memory in amt only, larger ones a partial Fisher-Yates shuffle of all the indexes
+	 *
+	 * @param total the number of indexes to choose from
+	 * @param amt the number of indexes to take, can't be more than total
+	 * @return the indexes, every ordered selection is equally likely
+	 */
+	std::vector<uint64_t> unifRandIndexes(uint64_t total, uint64_t amt) {
+		if (amt > total) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error " << "requesting " << amt << " indexes out of only " << total << std::endl;
+			throw std::runtime_error { ss.str() };
+		}
+		std::vector<uint64_t> ret;
+		if (amt < total / 8) {
+			//Floyd, each j either adds a new random index below it or itself
+			ret.reserve(amt);
+			std::unordered_set<uint64_t> chosen;
+			chosen.reserve(amt);
+			for (uint64_t j = total - amt; j < total; ++j) {
+				const uint64_t pick = boundedRand(mtGen_, j + 1);
+				ret.emplace_back(chosen.emplace(pick).second ? pick : j);
+				if (ret.back() == j) {
+					chosen.emplace(j);
+				}
+			}
+			//Floyd picks a random set but not a random order
+			shuffleInPlace(ret);
+		} else {
+			ret.resize(total);
+			std::iota(ret.begin(), ret.end(), 0);
+			for (uint64_t pos = 0; pos < amt; ++pos) {
+				std::swap(ret[pos], ret[pos + boundedRand(mtGen_, total - pos)]);
+			}
+			ret.resize(amt);
 		}
 		return ret;
 	}
+	/**@brief Shuffle a vector with Fisher-Yates on the unbiased bounded draws, so a seed gives the same order with any standard library
+	 *
+	 * @param vec the vector to shuffle
+	 */
+	template<typename T>
+	void shuffleInPlace(std::vector<T> & vec) {
+		for (uint64_t pos = vec.size(); pos > 1; --pos) {
+			std::swap(vec[pos - 1], vec[boundedRand(mtGen_, pos)]);
+		}
+	}
 
 	/**@brief seed mtGen_ with a new seed from random_device
 	 *
@@ -158,9 +384,57 @@ public:
 	 * @param givenSeed
 	 */
 	void seedNum(uint64_t givenSeed) {
+		seedNum(givenSeed, 0);
+	}
+	/**@brief seed mtGen_ with the given seed and stream
+	 *
+	 * @param givenSeed the seed
+	 * @param stream the stream
+	 */
+	void seedNum(uint64_t givenSeed, uint64_t stream) {
 		currentSeed_ = givenSeed;
-		mtGen_.seed(givenSeed);
+		currentStream_ = stream;
+		seedEngineStream(mtGen_, givenSeed, stream);
+	}
+	/**@brief Get a generator for another stream of the current seed, e.g. one for each thread so results don't depend on the threading
+	 *
+	 * @param stream the stream
+	 * @return a new generator seeded with currentSeed_ and stream
+	 */
+	randomGeneratorT split(uint64_t stream) const {
+		return randomGeneratorT(currentSeed_, stream);
 	}
+
+private:
+	static constexpr size_t batchSize_ = 256; /**< how many engine outputs the fill functions draw at once */
+
+	template<typename T>
+	static uint64_t intRange(T start, T stop) {
+		if (stop < start) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error " << "stop: " << stop << " is less than start: " << start << std::endl;
+			throw std::runtime_error { ss.str() };
+		}
+		if (stop == start) {
+			//an empty range gives start as before
+			return 1;
+		}
+		return static_cast<uint64_t>(stop) - static_cast<uint64_t>(start);
+	}
+
 };
 
+/**@brief The original generator on std::mt19937_64
+ *
+ */
+typedef randomGeneratorT<std::mt19937_64> randomGenerator;
+/**@brief A generator on xoshiro256**, much smaller state and cheaper seeding than std::mt19937_64
+ *
+ */
+typedef randomGeneratorT<Xoshiro256ss> fastRandomGenerator;
+/**@brief A generator on the counter-based Philox4x64, any stream can be made in constant time so is best for many parallel streams
+ *
+ */
+typedef randomGeneratorT<Philox4x64> parallelRandomGenerator;
+
 }  // namespace njh
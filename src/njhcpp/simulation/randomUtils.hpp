@@ -0,0 +1,114 @@
+#pragma once
+/*
+ * randomUtils.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <random>
+#include <limits>
+#include <cstdint>
+
+namespace njh {
+
+/**@brief Whether a generator returns all 64 bit values so its output can be used directly without going through a distribution
+ *
+ */
+template<typename URNG>
+constexpr bool isFull64BitGen() {
+	return URNG::min() == 0 && URNG::max() == std::numeric_limits<uint64_t>::max();
+}
+
+/**@brief Get 64 random bits from a generator
+ *
+ * @param gen the generator
+ * @return a uniform 64 bit number
+ */
+template<typename URNG>
+inline uint64_t rand64(URNG & gen) {
+	if constexpr (isFull64BitGen<URNG>()) {
+		return gen();
+	} else {
+		return std::uniform_int_distribution<uint64_t>()(gen);
+	}
+}
+
+/**@brief The high and low 64 bits of the 128 bit product of a and b
+ *
+ * @param a the first number
+ * @param b the second number
+ * @param low the low 64 bits of the product are put here
+ * @return the high 64 bits of the product
+ */
+inline uint64_t mulHigh64(uint64_t a, uint64_t b, uint64_t & low) {
+#if defined(__SIZEOF_INT128__)
+	const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	low = static_cast<uint64_t>(product);
+	return static_cast<uint64_t>(product >> 64);
+#else
+	const uint64_t aLo = a & 0xFFFFFFFF;
+	const uint64_t aHi = a >> 32;
+	const uint64_t bLo = b & 0xFFFFFFFF;
+	const uint64_t bHi = b >> 32;
+	const uint64_t loLo = aLo * bLo;
+	const uint64_t hiLo = aHi * bLo;
+	const uint64_t loHi = aLo * bHi;
+	const uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+	low = (cross << 32) | (loLo & 0xFFFFFFFF);
+	return aHi * bHi + (hiLo >> 32) + (cross >> 32);
+#endif
+}
+
+/**@brief An unbiased random number in [0,range) by Lemire's (2019) multiply and shift, which only needs a division in the rare case of a rejection
+ *
+ * @param gen the generator
+ * @param range the number of possible values, should be greater than 0
+ * @return a random number in [0,range)
+ */
+template<typename URNG>
+inline uint64_t boundedRand(URNG & gen, uint64_t range) {
+	uint64_t low = 0;
+	uint64_t ret = mulHigh64(rand64(gen), range, low);
+	if (low < range) {
+		//the values below (2^64 - range) % range would make some results more likely
+		const uint64_t threshold = (0 - range) % range;
+		while (low < threshold) {
+			ret = mulHigh64(rand64(gen), range, low);
+		}
+	}
+	return ret;
+}
+
+/**@brief One step of SplitMix64, used to expand a single seed into well mixed engine state
+ *
+ * @param state the SplitMix64 state, advanced by the call
+ * @return the next 64 bit output
+ */
+inline uint64_t splitMix64(uint64_t & state) {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/**@brief Turn 64 random bits into a double in [0,1) using the top 53 bits, so every value is a multiple of 2^-53
+ *
+ * @param bits the random bits
+ * @return a double in [0,1)
+ */
+inline double toUnitDouble(uint64_t bits) {
+	return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+/**@brief Turn 64 random bits into a double in (0,1), never 0 or 1 so it's safe to take the log of
+ *
+ * @param bits the random bits
+ * @return a double in (0,1)
+ */
+inline double toOpenUnitDouble(uint64_t bits) {
+	return (static_cast<double>(bits >> 11) + 0.5) * 0x1.0p-53;
+}
+
+}  // namespace njh
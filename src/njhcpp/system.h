@@ -8,3 +8,5 @@
 
 
 #include "njhcpp/system/sysUtils.hpp"
+#include "njhcpp/system/JobScheduler.hpp"
+#include "njhcpp/system/CmdCache.hpp"
@@ -0,0 +1,311 @@
+#pragma once
+/*
+ * CmdCache.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include "njhcpp/system/runProcess.hpp"
+#include "njhcpp/files/fileUtilities.hpp" //files::firstFileIsOlder
+#include "njhcpp/md5/md5.hpp"
+#include "njhcpp/utils/time.h"
+
+#include <mutex>
+#include <fstream>
+
+namespace njh {
+namespace sys {
+
+/**@brief Make style memoization of external commands, a command is skipped if it has succeeded before with the same inputs
+ * and its outputs are still there, unchanged and no older than its inputs
+ *
+ * Successful runs are recorded in a manifest keyed by the md5 of the command, along with a fingerprint of the declared
+ * inputs (size and modification time, or the md5 of their contents with hashInputContents_) and of the outputs.
+ * The manifest is JSON Lines, each run appends a line (a failed run appends the key with null to forget it) so an interrupted
+ * pipeline picks up where it stopped, later lines win when loading and the file is compacted on load once it's mostly
+ * superseded lines. Safe to share between threads.
+ *
+ */
+class CmdCache {
+public:
+	struct Pars {
+		bool hashInputContents_ = false; /**< fingerprint inputs by the md5 of their contents rather than by size and modification time */
+		bool verbose_ = false; /**< print whether each command was run or skipped */
+		size_t maxStoredOutputBytes_ = 64 * 1024; /**< the most of each of stdout and stderr kept in the manifest for skipped runs to return */
+	};
+
+	/**@brief Hits, misses and time saved so far
+	 *
+	 */
+	struct Stats {
+		uint64_t hits_ = 0; /**< commands skipped */
+		uint64_t misses_ = 0; /**< commands run */
+		double timeSaved_ = 0; /**< the recorded run time of the skipped commands in seconds */
+		double timeRun_ = 0; /**< the time spent running commands in seconds */
+
+		double hitRate() const {
+			return 0 == hits_ + misses_ ? 0 : static_cast<double>(hits_) / (hits_ + misses_);
+		}
+
+		Json::Value toJson() const {
+			Json::Value ret;
+			ret["class"] = "njh::sys::CmdCache::Stats";
+			ret["hits_"] = json::toJson(hits_);
+			ret["misses_"] = json::toJson(misses_);
+			ret["hitRate"] = json::toJson(hitRate());
+			ret["timeSaved_"] = json::toJson(timeSaved_);
+			ret["timeRun_"] = json::toJson(timeRun_);
+			return ret;
+		}
+	};
+
+	/**@brief Construct with a manifest, loaded if it already exists
+	 *
+	 * @param manifestFnp the manifest file
+	 */
+	explicit CmdCache(const bfs::path & manifestFnp) :
+			CmdCache(manifestFnp, Pars()) {
+	}
+
+	CmdCache(const bfs::path & manifestFnp, const Pars & pars) :
+			manifestFnp_(manifestFnp), pars_(pars) {
+		manifest_ = Json::Value(Json::objectValue);
+		if (bfs::exists(manifestFnp_)) {
+			loadManifest();
+		}
+		manifestOut_.open(manifestFnp_.string(), std::ios::app);
+		if (!manifestOut_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in opening " << manifestFnp_ << " for appending" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+
+	/**@brief Check whether a command would be skipped
+	 *
+	 * @param cmd the command
+	 * @param inputs the files the command reads
+	 * @param outputs the files the command writes
+	 * @return true if the command has succeeded before with these inputs and its outputs are up to date
+	 */
+	bool upToDate(const std::string & cmd, const std::vector<bfs::path> & inputs, const std::vector<bfs::path> & outputs) {
+		const std::string key = md5Hex(cmd);
+		std::string inputPrint = inputsFingerprint(inputs);
+		std::lock_guard<std::mutex> lock(mut_);
+		return upToDateNoLock(key, inputPrint, inputs, outputs);
+	}
+
+	/**@brief Run a command unless it's up to date, see upToDate()
+	 *
+	 * @param cmd the command
+	 * @param inputs the files the command reads
+	 * @param outputs the files the command writes
+	 * @param runPars settings for running the command
+	 * @return the output of the command, or on a skip the recorded stdout and stderr with time_ set to 0
+	 */
+	RunOutput run(const std::string & cmd, const std::vector<bfs::path> & inputs,
+			const std::vector<bfs::path> & outputs, const RunPars & runPars = RunPars()) {
+		const std::string key = md5Hex(cmd);
+		const std::string inputPrint = inputsFingerprint(inputs);
+		{
+			std::lock_guard<std::mutex> lock(mut_);
+			if (upToDateNoLock(key, inputPrint, inputs, outputs)) {
+				const Json::Value & entry = manifest_[key];
+				++stats_.hits_;
+				stats_.timeSaved_ += entry["time_"].asDouble();
+				if (pars_.verbose_) {
+					std::cout << "Skipping, up to date: " << cmd << std::endl;
+				}
+				RunOutput ret(true, 0, entry["stdOut_"].asString(), entry["stdErr_"].asString(), cmd, 0);
+				ret.stdOutTruncated_ = entry["stdOutTruncated_"].asBool();
+				ret.stdErrTruncated_ = entry["stdErrTruncated_"].asBool();
+				return ret;
+			}
+		}
+		if (pars_.verbose_) {
+			std::cout << "Running: " << cmd << std::endl;
+		}
+		auto ret = runProcess(cmd, runPars);
+		Json::Value entry;
+		if (ret.success_) {
+			entry["cmd_"] = cmd;
+			entry["inputs_"] = inputPrint;
+			for (const auto & output : outputs) {
+				entry["outputs_"][output.string()] = fileFingerprint(output);
+			}
+			entry["time_"] = json::toJson(ret.time_);
+			entry["stdOut_"] = ret.stdOut_.substr(0, pars_.maxStoredOutputBytes_);
+			entry["stdErr_"] = ret.stdErr_.substr(0, pars_.maxStoredOutputBytes_);
+			entry["stdOutTruncated_"] = ret.stdOutTruncated_ || ret.stdOut_.size() > pars_.maxStoredOutputBytes_;
+			entry["stdErrTruncated_"] = ret.stdErrTruncated_ || ret.stdErr_.size() > pars_.maxStoredOutputBytes_;
+			entry["date_"] = getCurrentDateFull();
+		}
+		//a failed run leaves the outputs in an unknown state, so it's recorded as null to forget any earlier success
+		Json::Value line;
+		line[key] = entry;
+		const std::string lineText = json::writeAsOneLine(line);
+		std::lock_guard<std::mutex> lock(mut_);
+		++stats_.misses_;
+		stats_.timeRun_ += ret.time_;
+		if (ret.success_) {
+			manifest_[key] = std::move(entry);
+		} else {
+			manifest_.removeMember(key);
+		}
+		appendToManifest(lineText);
+		return ret;
+	}
+
+	Stats stats() {
+		std::lock_guard<std::mutex> lock(mut_);
+		return stats_;
+	}
+
+	/**@brief Print the hits, misses and time saved
+	 *
+	 * @param out the stream to print to
+	 */
+	void printStats(std::ostream & out) {
+		auto current = stats();
+		out << "Cached commands: " << current.hits_ << " skipped, " << current.misses_ << " run, hit rate "
+				<< current.hitRate() * 100 << "%, " << current.timeSaved_ << "s saved" << std::endl;
+	}
+
+private:
+	bfs::path manifestFnp_;
+	Pars pars_;
+	Json::Value manifest_;
+	std::ofstream manifestOut_;
+	Stats stats_;
+	std::mutex mut_;
+
+	static std::string md5Hex(const std::string & str) {
+		return MD5(str).hexdigest();
+	}
+
+	std::string fileFingerprint(const bfs::path & fnp) const {
+		if (!bfs::exists(fnp)) {
+			return "missing";
+		}
+		if (bfs::is_directory(fnp)) {
+			return "dir:" + std::to_string(bfs::last_write_time(fnp));
+		}
+		return std::to_string(bfs::file_size(fnp)) + ":" + std::to_string(bfs::last_write_time(fnp));
+	}
+
+	static std::string contentFingerprint(const bfs::path & fnp) {
+		std::ifstream inFile(fnp.string(), std::ios::binary);
+		if (!inFile) {
+			return "missing";
+		}
+		MD5 md5;
+		std::vector<char> buffer(1024 * 64);
+		while (inFile.read(buffer.data(), buffer.size()) || inFile.gcount() > 0) {
+			md5.update(buffer.data(), inFile.gcount());
+		}
+		return md5.finalize().hexdigest();
+	}
+
+	std::string inputsFingerprint(const std::vector<bfs::path> & inputs) const {
+		std::string ret;
+		for (const auto & input : inputs) {
+			ret += input.string() + "\t"
+					+ (pars_.hashInputContents_ && bfs::is_regular_file(input) ? contentFingerprint(input) : fileFingerprint(input)) + "\n";
+		}
+		return md5Hex(ret);
+	}
+
+	bool upToDateNoLock(const std::string & key, const std::string & inputPrint,
+			const std::vector<bfs::path> & inputs, const std::vector<bfs::path> & outputs) const {
+		if (!manifest_.isMember(key) || manifest_[key]["inputs_"].asString() != inputPrint) {
+			return false;
+		}
+		const Json::Value & recordedOutputs = manifest_[key]["outputs_"];
+		for (const auto & output : outputs) {
+			if (!bfs::exists(output)
+					|| recordedOutputs[output.string()].asString() != fileFingerprint(output)) {
+				return false;
+			}
+			for (const auto & input : inputs) {
+				if (bfs::exists(input) && files::firstFileIsOlder(output, input)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void appendToManifest(const std::string & lineText) {
+		manifestOut_ << lineText << "\n";
+		manifestOut_.flush();
+		if (!manifestOut_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in writing to " << manifestFnp_ << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+
+	/**@brief Read the manifest's lines into manifest_, a cut off last line from an interrupted run is ignored,
+	 * and rewrite it without the superseded lines if they're most of it
+	 *
+	 */
+	void loadManifest() {
+		std::ifstream inFile(manifestFnp_.string());
+		std::string lineText;
+		uint64_t numLines = 0;
+		bool badLine = false;
+		while (std::getline(inFile, lineText)) {
+			if (lineText.empty()) {
+				continue;
+			}
+			if (badLine) {
+				//only the last line can be cut off
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error in parsing line " << numLines << " of " << manifestFnp_ << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+			++numLines;
+			Json::Value line;
+			try {
+				line = json::parse(lineText);
+			} catch (const std::exception &) {
+				badLine = true;
+				continue;
+			}
+			for (const auto & key : line.getMemberNames()) {
+				if (line[key].isNull()) {
+					manifest_.removeMember(key);
+				} else {
+					manifest_[key] = line[key];
+				}
+			}
+		}
+		if (badLine || numLines > 2 * manifest_.size() + 16) {
+			compactManifest();
+		}
+	}
+
+	void compactManifest() const {
+		//write then rename so a crash mid write doesn't lose the manifest
+		const bfs::path tempFnp = manifestFnp_.string() + ".tmp";
+		{
+			std::ofstream outFile(tempFnp.string());
+			if (!outFile) {
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error in opening " << tempFnp << " for writing" << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+			for (const auto & key : manifest_.getMemberNames()) {
+				Json::Value line;
+				line[key] = manifest_[key];
+				outFile << json::writeAsOneLine(line) << "\n";
+			}
+		}
+		bfs::rename(tempFnp, manifestFnp_);
+	}
+};
+
+}  // namespace sys
+}  // namespace njh
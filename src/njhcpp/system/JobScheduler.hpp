@@ -0,0 +1,379 @@
+#pragma once
+/*
+ * JobScheduler.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include "njhcpp/utils/utils.hpp"
+#include "njhcpp/system/runProcess.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <iostream>
+
+#include <unistd.h>
+
+namespace njh {
+namespace sys {
+
+/**@brief A command for JobScheduler along with what it needs before it can start
+ *
+ */
+struct Job {
+	std::string id_; /**< unique id, results are keyed by this */
+	std::string cmd_; /**< the command, run through /bin/sh */
+	std::vector<std::string> dependsOn_; /**< ids of jobs that have to succeed before this one starts */
+	uint32_t cpus_ = 1; /**< the cpus reserved while running, a job reserving 0 still needs one of the scheduler's worker threads */
+	uint64_t memoryMb_ = 0; /**< the memory reserved while running, in megabytes */
+	int32_t priority_ = 0; /**< of the jobs ready to go, higher priority starts first */
+	uint32_t retries_ = 0; /**< how many more times to try if the command fails */
+	RunPars runPars_; /**< capture and timeout settings for the command */
+};
+
+/**@brief What happened to a Job
+ *
+ */
+struct JobResult {
+	enum class Status {
+		succeeded, failed, cancelled
+	};
+	Status status_ = Status::cancelled;
+	uint32_t attempts_ = 0; /**< times the command was run, 0 if cancelled */
+	RunOutput output_; /**< the output of the last attempt */
+
+	static std::string statusStr(Status status) {
+		switch (status) {
+		case Status::succeeded:
+			return "succeeded";
+		case Status::failed:
+			return "failed";
+		case Status::cancelled:
+			return "cancelled";
+		}
+		return "";
+	}
+
+	/**@brief convert to json object from jsoncpp
+	 *
+	 * @return a json objects
+	 */
+	Json::Value toJson() const {
+		Json::Value ret;
+		ret["class"] = "njh::sys::JobResult";
+		ret["status_"] = statusStr(status_);
+		ret["attempts_"] = json::toJson(attempts_);
+		ret["output_"] = output_.toJson();
+		return ret;
+	}
+};
+
+/**@brief Run commands with dependencies between them on this machine, as many at a time as the cpus and memory they reserve allow
+ *
+ * Jobs start once everything they depend on has succeeded, the highest priority ready job that fits in what's free goes first
+ * and smaller jobs are backfilled around ones that don't fit yet. A job that fails (after its retries) cancels everything
+ * that depends on it, or with cancelOnFailure_ every job that hasn't started. Jobs run on a pool of at most Pars::cpus_ threads.
+ *
+ */
+class JobScheduler {
+public:
+	struct Pars {
+		uint32_t cpus_ = std::max(1U, std::thread::hardware_concurrency()); /**< cpus that can be reserved at once */
+		uint64_t memoryMb_ = physicalMemoryMb(); /**< megabytes that can be reserved at once */
+		bool cancelOnFailure_ = false; /**< on a failure start no more jobs, otherwise only the failed job's dependents are cancelled */
+		bool verbose_ = false; /**< print jobs as they start and finish */
+	};
+
+	JobScheduler() :
+			JobScheduler(Pars()) {
+	}
+
+	explicit JobScheduler(const Pars & pars) :
+			pars_(pars) {
+	}
+
+	/**@brief The machine's physical memory in megabytes
+	 *
+	 */
+	static uint64_t physicalMemoryMb() {
+		const long pages = ::sysconf(_SC_PHYS_PAGES);
+		const long pageSize = ::sysconf(_SC_PAGE_SIZE);
+		if (pages <= 0 || pageSize <= 0) {
+			return std::numeric_limits<uint64_t>::max();
+		}
+		return static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize) / (1024 * 1024);
+	}
+
+	/**@brief Add a job, its dependencies can be added before or after it
+	 *
+	 * @param job the job
+	 */
+	void addJob(Job job) {
+		if (njh::in(job.id_, jobIndex_)) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error, already have a job with id " << job.id_ << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		if (job.cpus_ > pars_.cpus_ || job.memoryMb_ > pars_.memoryMb_) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error, job " << job.id_ << " needs " << job.cpus_ << " cpus and " << job.memoryMb_
+					<< "MB but only " << pars_.cpus_ << " cpus and " << pars_.memoryMb_ << "MB are available" << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		jobIndex_[job.id_] = jobs_.size();
+		jobs_.emplace_back(std::move(job));
+	}
+
+	/**@brief Add a job
+	 *
+	 * @param id unique id
+	 * @param cmd the command
+	 * @param dependsOn ids of jobs that have to succeed first
+	 */
+	void addJob(const std::string & id, const std::string & cmd, const std::vector<std::string> & dependsOn = { }) {
+		Job job;
+		job.id_ = id;
+		job.cmd_ = cmd;
+		job.dependsOn_ = dependsOn;
+		addJob(std::move(job));
+	}
+
+	/**@brief Run all the added jobs, throws before starting anything if a dependency is missing or there's a cycle
+	 *
+	 * @return the result of every job keyed by id
+	 */
+	std::map<std::string, JobResult> run() {
+		const size_t nJobs = jobs_.size();
+		std::vector<std::vector<size_t>> dependents(nJobs);
+		std::vector<uint32_t> waitingOn(nJobs, 0);
+		for (size_t pos = 0; pos < nJobs; ++pos) {
+			for (const auto & dep : jobs_[pos].dependsOn_) {
+				auto depIt = jobIndex_.find(dep);
+				if (jobIndex_.end() == depIt) {
+					std::stringstream ss;
+					ss << __PRETTY_FUNCTION__ << ", error, job " << jobs_[pos].id_ << " depends on " << dep
+							<< " which hasn't been added" << "\n";
+					throw std::runtime_error { ss.str() };
+				}
+				dependents[depIt->second].emplace_back(pos);
+				++waitingOn[pos];
+			}
+		}
+		checkForCycle(dependents, waitingOn);
+
+		std::vector<JobResult> results(nJobs);
+		std::vector<bool> done(nJobs, false);
+		std::vector<size_t> ready;
+		for (size_t pos = 0; pos < nJobs; ++pos) {
+			if (0 == waitingOn[pos]) {
+				ready.emplace_back(pos);
+			}
+		}
+		std::mutex mut;
+		std::condition_variable finishedCv;
+		std::condition_variable startCv;
+		std::deque<size_t> toStart; /**< jobs that have their cpus and memory reserved, waiting on a worker */
+		bool noMoreJobs = false;
+		uint32_t freeCpus = pars_.cpus_;
+		uint64_t freeMemoryMb = pars_.memoryMb_;
+		uint32_t running = 0;
+		bool stopStarting = false;
+
+		//with mut held, cancel pos and everything downstream of it that hasn't finished
+		std::function<void(size_t)> cancel = [&](size_t pos) {
+			if (done[pos]) {
+				return;
+			}
+			done[pos] = true;
+			results[pos].status_ = JobResult::Status::cancelled;
+			for (const auto dependent : dependents[pos]) {
+				cancel(dependent);
+			}
+		};
+
+		auto runJob = [&](size_t pos) {
+			const Job & job = jobs_[pos];
+			JobResult result;
+			do {
+				++result.attempts_;
+				try {
+					result.output_ = runProcess(job.cmd_, job.runPars_);
+				} catch (const std::exception & e) {
+					result.output_ = RunOutput { false, -1, "", e.what(), job.cmd_, 0 };
+				}
+			} while (!result.output_.success_ && result.attempts_ <= job.retries_);
+			result.status_ = result.output_.success_ ? JobResult::Status::succeeded : JobResult::Status::failed;
+
+			std::lock_guard<std::mutex> lock(mut);
+			if (pars_.verbose_) {
+				std::cout << "Finished: " << job.id_ << " " << JobResult::statusStr(result.status_) << " in "
+						<< result.output_.time_ << "s" << std::endl;
+			}
+			results[pos] = std::move(result);
+			done[pos] = true;
+			freeCpus += job.cpus_;
+			freeMemoryMb += job.memoryMb_;
+			--running;
+			if (JobResult::Status::succeeded == results[pos].status_) {
+				for (const auto dependent : dependents[pos]) {
+					if (0 == --waitingOn[dependent] && !done[dependent]) {
+						ready.emplace_back(dependent);
+					}
+				}
+			} else {
+				for (const auto dependent : dependents[pos]) {
+					cancel(dependent);
+				}
+				if (pars_.cancelOnFailure_) {
+					stopStarting = true;
+				}
+			}
+			finishedCv.notify_one();
+		};
+
+		//a fixed pool of workers, jobs normally reserve at least one cpu so no more than pars_.cpus_ run at once anyway
+		auto worker = [&]() {
+			std::unique_lock<std::mutex> lock(mut);
+			while (true) {
+				startCv.wait(lock, [&]() {
+					return noMoreJobs || !toStart.empty();
+				});
+				if (toStart.empty()) {
+					return;
+				}
+				const size_t pos = toStart.front();
+				toStart.pop_front();
+				lock.unlock();
+				runJob(pos);
+				lock.lock();
+			}
+		};
+		std::vector<std::thread> workers;
+		auto stopWorkers = [&]() {
+			{
+				std::lock_guard<std::mutex> lock(mut);
+				noMoreJobs = true;
+			}
+			startCv.notify_all();
+			for (auto & t : workers) {
+				t.join();
+			}
+		};
+		const size_t numWorkers = std::min<size_t>(nJobs, std::max<uint32_t>(1, pars_.cpus_));
+		try {
+			for (size_t t = 0; t < numWorkers; ++t) {
+				workers.emplace_back(worker);
+			}
+		} catch (...) {
+			//joinable threads can't be destroyed, so stop the ones that did start before passing on the error
+			stopWorkers();
+			throw;
+		}
+		{
+			std::unique_lock<std::mutex> lock(mut);
+			while (true) {
+				if (stopStarting) {
+					for (size_t pos = 0; pos < nJobs; ++pos) {
+						if (!done[pos] && 0 == results[pos].attempts_) {
+							done[pos] = true;
+						}
+					}
+					ready.clear();
+				}
+				//highest priority first, ties in the order added
+				std::stable_sort(ready.begin(), ready.end(), [this](size_t job1, size_t job2) {
+					return jobs_[job1].priority_ > jobs_[job2].priority_;
+				});
+				for (auto readyIt = ready.begin(); readyIt != ready.end();) {
+					const Job & job = jobs_[*readyIt];
+					if (done[*readyIt]) {
+						readyIt = ready.erase(readyIt);
+					} else if (job.cpus_ <= freeCpus && job.memoryMb_ <= freeMemoryMb) {
+						freeCpus -= job.cpus_;
+						freeMemoryMb -= job.memoryMb_;
+						++running;
+						results[*readyIt].attempts_ = 1;
+						if (pars_.verbose_) {
+							std::cout << "Starting: " << job.id_ << std::endl;
+							std::cout << "\tRunning: " << job.cmd_ << std::endl;
+						}
+						toStart.emplace_back(*readyIt);
+						startCv.notify_one();
+						readyIt = ready.erase(readyIt);
+					} else {
+						++readyIt;
+					}
+				}
+				if (0 == running) {
+					break;
+				}
+				finishedCv.wait(lock);
+			}
+		}
+		stopWorkers();
+
+		std::map<std::string, JobResult> ret;
+		for (size_t pos = 0; pos < nJobs; ++pos) {
+			ret.emplace(jobs_[pos].id_, std::move(results[pos]));
+		}
+		return ret;
+	}
+
+	/**@brief Convert run() results to json
+	 *
+	 * @param results the results
+	 * @return a json object keyed by job id
+	 */
+	static Json::Value resultsToJson(const std::map<std::string, JobResult> & results) {
+		Json::Value ret(Json::objectValue);
+		for (const auto & result : results) {
+			ret[result.first] = result.second.toJson();
+		}
+		return ret;
+	}
+
+private:
+	Pars pars_;
+	std::vector<Job> jobs_;
+	std::unordered_map<std::string, size_t> jobIndex_;
+
+	void checkForCycle(const std::vector<std::vector<size_t>> & dependents, std::vector<uint32_t> waitingOn) const {
+		std::vector<size_t> noDeps;
+		for (size_t pos = 0; pos < waitingOn.size(); ++pos) {
+			if (0 == waitingOn[pos]) {
+				noDeps.emplace_back(pos);
+			}
+		}
+		size_t visited = 0;
+		while (!noDeps.empty()) {
+			const size_t pos = noDeps.back();
+			noDeps.pop_back();
+			++visited;
+			for (const auto dependent : dependents[pos]) {
+				if (0 == --waitingOn[dependent]) {
+					noDeps.emplace_back(dependent);
+				}
+			}
+		}
+		if (visited != waitingOn.size()) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error, the job dependencies have a cycle, involving:";
+			for (size_t pos = 0; pos < waitingOn.size(); ++pos) {
+				if (0 != waitingOn[pos]) {
+					ss << " " << jobs_[pos].id_;
+				}
+			}
+			ss << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+	}
+};
+
+}  // namespace sys
+}  // namespace njh
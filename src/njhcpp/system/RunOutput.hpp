@@ -12,16 +12,74 @@
 namespace njh {
 namespace sys {
 
+/**@brief The resources used by an external command and everything it waited on, from wait4() and /proc/[pid]/io
+ *
+ */
+struct ResourceUsage {
+	double userTime_ = 0; /**< user cpu time in seconds*/
+	double sysTime_ = 0; /**< system cpu time in seconds*/
+	int64_t maxRssKb_ = 0; /**< peak resident set size in kilobytes, of the largest single process*/
+	int64_t voluntaryCtxSwitches_ = 0; /**< context switches from waiting, e.g. on I/O*/
+	int64_t involuntaryCtxSwitches_ = 0; /**< context switches from being preempted*/
+	int64_t blockInputOps_ = 0; /**< file system block reads*/
+	int64_t blockOutputOps_ = 0; /**< file system block writes*/
+	int64_t readBytes_ = -1; /**< bytes read by read() and the like including pipes, -1 if /proc isn't available*/
+	int64_t writeBytes_ = -1; /**< bytes written by write() and the like including pipes, -1 if /proc isn't available*/
+	int64_t storageReadBytes_ = -1; /**< bytes actually fetched from storage, -1 if /proc isn't available*/
+	int64_t storageWriteBytes_ = -1; /**< bytes sent to storage, -1 if /proc isn't available*/
+
+	/**@brief convert to json object from jsoncpp
+	 *
+	 * @return a json objects
+	 */
+	Json::Value toJson() const {
+		Json::Value ret;
+		ret["class"] = "njh::sys::ResourceUsage";
+		ret["userTime_"] = json::toJson(userTime_);
+		ret["sysTime_"] = json::toJson(sysTime_);
+		ret["maxRssKb_"] = json::toJson(maxRssKb_);
+		ret["voluntaryCtxSwitches_"] = json::toJson(voluntaryCtxSwitches_);
+		ret["involuntaryCtxSwitches_"] = json::toJson(involuntaryCtxSwitches_);
+		ret["blockInputOps_"] = json::toJson(blockInputOps_);
+		ret["blockOutputOps_"] = json::toJson(blockOutputOps_);
+		ret["readBytes_"] = json::toJson(readBytes_);
+		ret["writeBytes_"] = json::toJson(writeBytes_);
+		ret["storageReadBytes_"] = json::toJson(storageReadBytes_);
+		ret["storageWriteBytes_"] = json::toJson(storageWriteBytes_);
+		return ret;
+	}
+};
+
 /**@brief struct for holding output and success status of an external command
  *@todo add original run command and run duration info
  */
 struct RunOutput {
-	bool success_; /**< whether the command was successful*/
-	int32_t returnCode_; /**< the return code of the command*/
+	bool success_ = false; /**< whether the command was successful*/
+	int32_t returnCode_ = 0; /**< the return code of the command*/
 	std::string stdOut_; /**< the output to stdout from the command*/
 	std::string stdErr_; /**< the output to stderr from the command*/
 	std::string cmd_; /**< the command*/
-	double time_; /**< time in millisecond */
+	double time_ = 0; /**< wall time in seconds */
+	bool timedOut_ = false; /**< whether the command was signaled for running past its timeout*/
+	bool stdOutTruncated_ = false; /**< whether stdOut_ was cut at the capture limit*/
+	bool stdErrTruncated_ = false; /**< whether stdErr_ was cut at the capture limit*/
+	ResourceUsage usage_; /**< cpu, memory and I/O used*/
+
+	RunOutput() = default;
+
+	/**@brief Construct with the basic outcome of a command, the rest are left at their defaults
+	 *
+	 * @param success whether the command was successful
+	 * @param returnCode the return code
+	 * @param stdOut the output to stdout
+	 * @param stdErr the output to stderr
+	 * @param cmd the command
+	 * @param time wall time in seconds
+	 */
+	RunOutput(bool success, int32_t returnCode, std::string stdOut, std::string stdErr, std::string cmd, double time) :
+			success_(success), returnCode_(returnCode), stdOut_(std::move(stdOut)), stdErr_(std::move(stdErr)),
+			cmd_(std::move(cmd)), time_(time) {
+	}
 
 	/**@brief So the struct can be tested in an if statement
 	 *
@@ -43,6 +101,73 @@ struct RunOutput {
 		ret["stdOut_"] = json::toJson(stdOut_);
 		ret["stdErr_"] = json::toJson(stdErr_);
 		ret["time_"] = json::toJson(time_);
+		ret["timedOut_"] = json::toJson(timedOut_);
+		ret["stdOutTruncated_"] = json::toJson(stdOutTruncated_);
+		ret["stdErrTruncated_"] = json::toJson(stdErrTruncated_);
+		ret["usage_"] = usage_.toJson();
+		return ret;
+	}
+};
+
+/**@brief Totals over several RunOutputs, e.g. from runCmdsThreaded(), for sizing thread counts against cpu and memory
+ *
+ */
+struct RunSummary {
+	uint32_t numCmds_ = 0;
+	uint32_t numFailed_ = 0;
+	double totalTime_ = 0; /**< summed wall time of the commands in seconds*/
+	double maxTime_ = 0; /**< the longest wall time in seconds*/
+	double totalUserTime_ = 0; /**< summed user cpu time in seconds*/
+	double totalSysTime_ = 0; /**< summed system cpu time in seconds*/
+	int64_t peakMaxRssKb_ = 0; /**< the largest peak resident set size of any command in kilobytes*/
+	double meanMaxRssKb_ = 0; /**< the mean peak resident set size in kilobytes*/
+	int64_t totalReadBytes_ = 0;
+	int64_t totalWriteBytes_ = 0;
+
+	/**@brief Add a command's output to the totals
+	 *
+	 * @param out the command's output
+	 */
+	void add(const RunOutput & out) {
+		meanMaxRssKb_ = (meanMaxRssKb_ * numCmds_ + out.usage_.maxRssKb_) / (numCmds_ + 1);
+		++numCmds_;
+		if (!out.success_) {
+			++numFailed_;
+		}
+		totalTime_ += out.time_;
+		maxTime_ = std::max(maxTime_, out.time_);
+		totalUserTime_ += out.usage_.userTime_;
+		totalSysTime_ += out.usage_.sysTime_;
+		peakMaxRssKb_ = std::max(peakMaxRssKb_, out.usage_.maxRssKb_);
+		totalReadBytes_ += std::max<int64_t>(0, out.usage_.readBytes_);
+		totalWriteBytes_ += std::max<int64_t>(0, out.usage_.writeBytes_);
+	}
+
+	/**@brief The average number of cores kept busy, cpu time over wall time
+	 *
+	 */
+	double meanCpuUse() const {
+		return totalTime_ > 0 ? (totalUserTime_ + totalSysTime_) / totalTime_ : 0;
+	}
+
+	/**@brief convert to json object from jsoncpp
+	 *
+	 * @return a json objects
+	 */
+	Json::Value toJson() const {
+		Json::Value ret;
+		ret["class"] = "njh::sys::RunSummary";
+		ret["numCmds_"] = json::toJson(numCmds_);
+		ret["numFailed_"] = json::toJson(numFailed_);
+		ret["totalTime_"] = json::toJson(totalTime_);
+		ret["maxTime_"] = json::toJson(maxTime_);
+		ret["totalUserTime_"] = json::toJson(totalUserTime_);
+		ret["totalSysTime_"] = json::toJson(totalSysTime_);
+		ret["meanCpuUse"] = json::toJson(meanCpuUse());
+		ret["peakMaxRssKb_"] = json::toJson(peakMaxRssKb_);
+		ret["meanMaxRssKb_"] = json::toJson(meanMaxRssKb_);
+		ret["totalReadBytes_"] = json::toJson(totalReadBytes_);
+		ret["totalWriteBytes_"] = json::toJson(totalWriteBytes_);
 		return ret;
 	}
 };
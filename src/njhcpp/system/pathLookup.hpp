@@ -0,0 +1,160 @@
+#pragma once
+/*
+ * pathLookup.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <cstdlib>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace njh {
+namespace sys {
+
+namespace impl {
+
+/**@brief Programs already looked up in PATH, for the life of the process or until PATH changes
+ *
+ */
+struct PathCache {
+	std::mutex mut_;
+	std::string path_; /**< the PATH the lookups were done with */
+	std::unordered_map<std::string, std::string> found_; /**< program to full path, empty if not found */
+
+	static PathCache & instance() {
+		static PathCache cache;
+		return cache;
+	}
+
+	/**@brief Clear the cache if PATH has changed, call with mut_ held
+	 *
+	 */
+	void checkPath() {
+		const char * path = ::getenv("PATH");
+		const std::string current = nullptr == path ? "" : path;
+		if (current != path_) {
+			path_ = current;
+			found_.clear();
+		}
+	}
+
+	std::vector<std::string> dirs() const {
+		std::vector<std::string> ret;
+		size_t start = 0;
+		while (start <= path_.size()) {
+			const size_t end = std::min(path_.find(':', start), path_.size());
+			//an empty entry means the current directory
+			ret.emplace_back(end == start ? "." : path_.substr(start, end - start));
+			start = end + 1;
+		}
+		return ret;
+	}
+};
+
+/**@brief Whether fnp is a regular file this process can execute
+ *
+ */
+inline bool isExecutableFile(const std::string & fnp) {
+	struct stat info;
+	return 0 == ::stat(fnp.c_str(), &info) && S_ISREG(info.st_mode) && 0 == ::access(fnp.c_str(), X_OK);
+}
+
+}  // namespace impl
+
+/**@brief Find where programs are in PATH like which does, but without starting a shell, results are cached until PATH changes
+ *
+ * Each PATH directory is listed at most once for all the programs not already cached, so checking many programs costs about the same as checking one
+ *
+ * @param programs the programs, ones containing a / are checked as paths instead
+ * @return each program's full path, an empty string for ones not found
+ */
+inline std::unordered_map<std::string, std::string> findInPath(const std::vector<std::string> & programs) {
+	auto & cache = impl::PathCache::instance();
+	std::lock_guard<std::mutex> lock(cache.mut_);
+	cache.checkPath();
+	std::unordered_map<std::string, std::string> ret;
+	std::unordered_set<std::string> unresolved;
+	for (const auto & program : programs) {
+		auto cached = cache.found_.find(program);
+		if (cache.found_.end() != cached) {
+			ret[program] = cached->second;
+		} else if (std::string::npos != program.find('/')) {
+			ret[program] = impl::isExecutableFile(program) ? program : "";
+			cache.found_[program] = ret[program];
+		} else if (!program.empty()) {
+			unresolved.emplace(program);
+		} else {
+			ret[program] = "";
+		}
+	}
+	if (1 == unresolved.size()) {
+		//for one program checking each directory directly beats listing them
+		for (const auto & dir : cache.dirs()) {
+			const std::string candidate = dir + "/" + *unresolved.begin();
+			if (impl::isExecutableFile(candidate)) {
+				ret[*unresolved.begin()] = candidate;
+				cache.found_[*unresolved.begin()] = candidate;
+				unresolved.clear();
+				break;
+			}
+		}
+	} else if (!unresolved.empty()) {
+		for (const auto & dir : cache.dirs()) {
+			DIR * dirHandle = ::opendir(dir.c_str());
+			if (nullptr == dirHandle) {
+				continue;
+			}
+			while (dirent * entry = ::readdir(dirHandle)) {
+				auto wanted = unresolved.find(entry->d_name);
+				if (unresolved.end() != wanted) {
+					const std::string candidate = dir + "/" + *wanted;
+					if (impl::isExecutableFile(candidate)) {
+						ret[*wanted] = candidate;
+						cache.found_[*wanted] = candidate;
+						unresolved.erase(wanted);
+					}
+				}
+			}
+			::closedir(dirHandle);
+			if (unresolved.empty()) {
+				break;
+			}
+		}
+	}
+	for (const auto & program : unresolved) {
+		ret[program] = "";
+		cache.found_[program] = "";
+	}
+	return ret;
+}
+
+/**@brief Find where a program is in PATH, see findInPath(const std::vector<std::string> &)
+ *
+ * @param program the program
+ * @return the program's full path, or an empty string if not found
+ */
+inline std::string findInPath(const std::string & program) {
+	return findInPath(std::vector<std::string> { program })[program];
+}
+
+/**@brief Forget all the cached lookups, e.g. after installing a program
+ *
+ */
+inline void clearPathCache() {
+	auto & cache = impl::PathCache::instance();
+	std::lock_guard<std::mutex> lock(cache.mut_);
+	cache.found_.clear();
+}
+
+}  // namespace sys
+}  // namespace njh
@@ -0,0 +1,372 @@
+#pragma once
+/*
+ * runProcess.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include "njhcpp/utils/stringUtils.hpp"
+#include "njhcpp/bashUtils/textFormatter.hpp"
+#include "njhcpp/utils/time.h"
+#include "njhcpp/system/RunOutput.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+
+#include <spawn.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+extern char **environ;
+
+namespace njh {
+namespace sys {
+
+/**@brief How one of a command's output streams is captured
+ *
+ */
+struct StreamCapturePars {
+	size_t maxBytes_ = std::numeric_limits<size_t>::max(); /**< the most bytes kept in the RunOutput, the rest is dropped (but still spooled and passed to lineCallback_) */
+	bfs::path spoolFnp_; /**< if set the whole stream is also written to this file as it comes in */
+	std::function<void(const std::string &)> lineCallback_; /**< if set, called with each line (without the newline) as it comes in */
+};
+
+/**@brief Settings for run()
+ *
+ */
+struct RunPars {
+	StreamCapturePars stdOut_;
+	StreamCapturePars stdErr_;
+	std::chrono::milliseconds timeout_ { 0 }; /**< if more than 0, the command is sent SIGTERM once it has run this long */
+	std::chrono::milliseconds killGrace_ { 5000 }; /**< how long after SIGTERM before SIGKILL */
+	bool trimWhiteSpace_ = true; /**< trim the captured output */
+	bool removeTerminalCodes_ = true; /**< remove terminal escape codes from the captured output */
+};
+
+namespace impl {
+
+/**@brief One of the child's output pipes, accumulating what's read from it
+ *
+ */
+class CapturedStream {
+public:
+	/**@brief Open the spool file if there is one, the pipe's read end is handed over with fd_ afterwards so a failure here leaks nothing
+	 *
+	 * @param pars the capture settings
+	 */
+	explicit CapturedStream(const StreamCapturePars & pars) :
+			pars_(pars) {
+		if (!pars_.spoolFnp_.empty()) {
+			spool_.open(pars_.spoolFnp_.string(), std::ios::binary);
+			if (!spool_) {
+				std::stringstream ss;
+				ss << __PRETTY_FUNCTION__ << ", error in opening " << pars_.spoolFnp_ << " for writing" << "\n";
+				throw std::runtime_error { ss.str() };
+			}
+		}
+	}
+
+	~CapturedStream() {
+		if (fd_ >= 0) {
+			::close(fd_);
+		}
+	}
+
+	int fd_ = -1; /**< the pipe's read end, closed by this */
+	std::string captured_;
+	bool truncated_ = false;
+
+	/**@brief Read what's available
+	 *
+	 * @return false once the pipe is closed
+	 */
+	bool readAvailable() {
+		char buf[1024 * 64];
+		ssize_t got = ::read(fd_, buf, sizeof(buf));
+		while (got < 0 && EINTR == errno) {
+			got = ::read(fd_, buf, sizeof(buf));
+		}
+		if (got <= 0) {
+			finish();
+			return false;
+		}
+		add(buf, got);
+		return true;
+	}
+
+	void finish() {
+		if (fd_ >= 0) {
+			::close(fd_);
+			fd_ = -1;
+		}
+		if (pars_.lineCallback_ && !partialLine_.empty()) {
+			pars_.lineCallback_(partialLine_);
+			partialLine_.clear();
+		}
+		if (spool_.is_open()) {
+			spool_.close();
+		}
+	}
+
+private:
+	const StreamCapturePars & pars_;
+	std::ofstream spool_;
+	std::string partialLine_;
+
+	void add(const char * buf, size_t len) {
+		if (captured_.size() < pars_.maxBytes_) {
+			const size_t keep = std::min(len, pars_.maxBytes_ - captured_.size());
+			captured_.append(buf, keep);
+			truncated_ = truncated_ || keep < len;
+		} else {
+			truncated_ = true;
+		}
+		if (spool_.is_open()) {
+			spool_.write(buf, len);
+		}
+		if (pars_.lineCallback_) {
+			const char * start = buf;
+			const char * end = buf + len;
+			const char * newLine = nullptr;
+			while (nullptr != (newLine = static_cast<const char *>(std::memchr(start, '\n', end - start)))) {
+				partialLine_.append(start, newLine);
+				pars_.lineCallback_(partialLine_);
+				partialLine_.clear();
+				start = newLine + 1;
+			}
+			partialLine_.append(start, end);
+		}
+	}
+};
+
+/**@brief Add the I/O counts from /proc/[pid]/io, which includes the children the process has waited on, left at -1 where there's no /proc
+ *
+ * @param pid the process, must not have been reaped yet
+ * @param usage the usage to set
+ */
+inline void readProcIo(pid_t pid, ResourceUsage & usage) {
+	std::ifstream ioFile("/proc/" + std::to_string(pid) + "/io");
+	std::string key;
+	int64_t val = 0;
+	while (ioFile >> key >> val) {
+		if ("rchar:" == key) {
+			usage.readBytes_ = val;
+		} else if ("wchar:" == key) {
+			usage.writeBytes_ = val;
+		} else if ("read_bytes:" == key) {
+			usage.storageReadBytes_ = val;
+		} else if ("write_bytes:" == key) {
+			usage.storageWriteBytes_ = val;
+		}
+	}
+}
+
+/**@brief Copy the counts from wait4()'s rusage
+ *
+ * @param childUsage the rusage
+ * @param usage the usage to set
+ */
+inline void setFromRusage(const rusage & childUsage, ResourceUsage & usage) {
+	usage.userTime_ = childUsage.ru_utime.tv_sec + childUsage.ru_utime.tv_usec / 1e6;
+	usage.sysTime_ = childUsage.ru_stime.tv_sec + childUsage.ru_stime.tv_usec / 1e6;
+#if defined( __APPLE__ ) || defined( __APPLE_CC__ ) || defined( macintosh ) || defined( __MACH__ )
+	//bytes on mac, kilobytes elsewhere
+	usage.maxRssKb_ = childUsage.ru_maxrss / 1024;
+#else
+	usage.maxRssKb_ = childUsage.ru_maxrss;
+#endif
+	usage.voluntaryCtxSwitches_ = childUsage.ru_nvcsw;
+	usage.involuntaryCtxSwitches_ = childUsage.ru_nivcsw;
+	usage.blockInputOps_ = childUsage.ru_inblock;
+	usage.blockOutputOps_ = childUsage.ru_oublock;
+}
+
+/**@brief Create a pipe with both ends closed on exec, so commands started on other threads don't inherit them
+ *
+ * @param fds set to the read and write ends
+ * @return 0 on success, -1 with errno set otherwise
+ */
+inline int closeOnExecPipe(int fds[2]) {
+#if defined(__linux__)
+	return ::pipe2(fds, O_CLOEXEC);
+#else
+	//no pipe2 on mac, there's a small window here where a command spawned on another thread could inherit the ends
+	if (0 != ::pipe(fds)) {
+		return -1;
+	}
+	if (-1 == ::fcntl(fds[0], F_SETFD, FD_CLOEXEC) || -1 == ::fcntl(fds[1], F_SETFD, FD_CLOEXEC)) {
+		const int err = errno;
+		::close(fds[0]);
+		::close(fds[1]);
+		errno = err;
+		return -1;
+	}
+	return 0;
+#endif
+}
+
+}  // namespace impl
+
+/**@brief Run a command through /bin/sh, reading its stdout and stderr at the same time so a child filling either pipe never stalls
+ *
+ * The child is started with posix_spawn and both pipes are waited on with poll(), so there's no busy waiting.
+ * With a timeout the command gets its own process group so SIGTERM, and SIGKILL killGrace_ later, reach everything it started.
+ *
+ * @param cmd the command
+ * @param pars the capture and timeout settings
+ * @return the status, outputs and resource usage of the command, returnCode_ is the raw status from wait4()
+ */
+inline RunOutput runProcess(const std::string & cmd, const RunPars & pars) {
+	njh::stopWatch watch;
+	//open any spool files before there are descriptors to leak
+	impl::CapturedStream outStream(pars.stdOut_);
+	impl::CapturedStream errStream(pars.stdErr_);
+	int outPipe[2];
+	int errPipe[2];
+	if (0 != impl::closeOnExecPipe(outPipe)) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error in creating pipe: " << std::strerror(errno) << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	//owns the read ends from here on
+	outStream.fd_ = outPipe[0];
+	if (0 != impl::closeOnExecPipe(errPipe)) {
+		const int err = errno;
+		::close(outPipe[1]);
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error in creating pipe: " << std::strerror(err) << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+	errStream.fd_ = errPipe[0];
+
+	const bool useTimeout = pars.timeout_.count() > 0;
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, errPipe[1], STDERR_FILENO);
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+	if (useTimeout) {
+		posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+		posix_spawnattr_setpgroup(&attr, 0);
+	}
+	std::string shell = "sh";
+	std::string flag = "-c";
+	std::string cmdCopy = cmd;
+	char * argv[] = { &shell[0], &flag[0], &cmdCopy[0], nullptr };
+	pid_t pid = 0;
+	const int spawnStatus = ::posix_spawn(&pid, "/bin/sh", &actions, &attr, argv, environ);
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+	::close(outPipe[1]);
+	::close(errPipe[1]);
+	if (0 != spawnStatus) {
+		std::stringstream ss;
+		ss << __PRETTY_FUNCTION__ << ", error in starting " << cmd << ": " << std::strerror(spawnStatus) << "\n";
+		throw std::runtime_error { ss.str() };
+	}
+
+	auto deadline = std::chrono::steady_clock::now() + pars.timeout_;
+	int signalsSent = 0;
+	bool timedOut = false;
+	auto sendNextSignal = [&]() {
+		const int sig = 0 == signalsSent ? SIGTERM : SIGKILL;
+		::kill(-pid, sig);
+		++signalsSent;
+		timedOut = true;
+		deadline = std::chrono::steady_clock::now() + pars.killGrace_;
+	};
+	auto msUntilDeadline = [&]() -> int {
+		if (!useTimeout || signalsSent > 1) {
+			return -1;
+		}
+		const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+		return static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(left, std::numeric_limits<int>::max())));
+	};
+
+	while (outStream.fd_ >= 0 || errStream.fd_ >= 0) {
+		pollfd fds[2];
+		nfds_t nfds = 0;
+		impl::CapturedStream * streams[2];
+		for (auto stream : { &outStream, &errStream }) {
+			if (stream->fd_ >= 0) {
+				fds[nfds].fd = stream->fd_;
+				fds[nfds].events = POLLIN;
+				fds[nfds].revents = 0;
+				streams[nfds] = stream;
+				++nfds;
+			}
+		}
+		const int ready = ::poll(fds, nfds, msUntilDeadline());
+		if (ready < 0 && EINTR != errno) {
+			std::stringstream ss;
+			ss << __PRETTY_FUNCTION__ << ", error in waiting on output of " << cmd << ": " << std::strerror(errno) << "\n";
+			throw std::runtime_error { ss.str() };
+		}
+		if (0 == ready) {
+			sendNextSignal();
+			continue;
+		}
+		for (nfds_t pos = 0; pos < nfds; ++pos) {
+			if (0 != fds[pos].revents) {
+				streams[pos]->readAvailable();
+			}
+		}
+	}
+
+	//wait for the command to exit without reaping it so /proc/[pid]/io can still be read
+	siginfo_t exitInfo;
+	if (useTimeout) {
+		//the pipes are closed so the command is finishing, back off while checking in case it hangs past the deadline
+		auto backOff = std::chrono::milliseconds(1);
+		exitInfo.si_pid = 0;
+		while (0 == ::waitid(P_PID, pid, &exitInfo, WEXITED | WNOWAIT | WNOHANG) && 0 == exitInfo.si_pid) {
+			if (signalsSent < 2 && std::chrono::steady_clock::now() >= deadline) {
+				sendNextSignal();
+			}
+			std::this_thread::sleep_for(backOff);
+			backOff = std::min(backOff * 2, std::chrono::milliseconds(50));
+		}
+	} else {
+		while (0 != ::waitid(P_PID, pid, &exitInfo, WEXITED | WNOWAIT) && EINTR == errno) {
+		}
+	}
+	ResourceUsage usage;
+	impl::readProcIo(pid, usage);
+	int status = 0;
+	rusage childUsage;
+	std::memset(&childUsage, 0, sizeof(childUsage));
+	while (pid != ::wait4(pid, &status, 0, &childUsage) && EINTR == errno) {
+	}
+	impl::setFromRusage(childUsage, usage);
+
+	RunOutput ret { WIFEXITED(status) && 0 == WEXITSTATUS(status), status, std::move(outStream.captured_),
+			std::move(errStream.captured_), cmd, watch.totalTime() };
+	for (auto out : { &ret.stdOut_, &ret.stdErr_ }) {
+		if (pars.removeTerminalCodes_) {
+			bashCT::trimForNonTerminalOutInPlace(*out);
+		}
+		if (pars.trimWhiteSpace_) {
+			trim(*out);
+		}
+	}
+	ret.timedOut_ = timedOut;
+	ret.stdOutTruncated_ = outStream.truncated_;
+	ret.stdErrTruncated_ = errStream.truncated_;
+	ret.usage_ = usage;
+	return ret;
+}
+
+}  // namespace sys
+}  // namespace njh
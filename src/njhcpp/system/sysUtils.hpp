@@ -13,6 +13,8 @@
 #include "njhcpp/utils/time.h"
 #include "njhcpp/system/CmdPool.hpp"
 #include "njhcpp/system/RunOutput.hpp"
+#include "njhcpp/system/runProcess.hpp"
+#include "njhcpp/system/pathLookup.hpp"
 #include "njhcpp/concurrency/concurrencyUtils.hpp"
 #include <pstreams/pstream.h>
 #include <thread>
@@ -20,87 +22,34 @@
 namespace njh{
 namespace sys{
 
+/**@brief run the command in cmds externally and return the status and outputs
+ *
+ * @param cmds A vector of strings contains the command, content of cmds will be converted to a string with space delimited every string in cmds
+ * @param pars settings for capturing the output and timing out
+ * @return A RunOutPut object holding status and outputs of the externally ran cmd
+ */
+inline RunOutput run(const std::vector<std::string> & cmds, const RunPars & pars) {
+	return runProcess(conToStr(cmds, " "), pars);
+}
+
 /**@brief run the command in cmds externally and return the status and outputs
  *
  * @param cmds A vector of strings contains the command, content of cmds will be converted to a string with space delimited every string in cmds
  * @return A RunOutPut object holding status and outputs of the externally ran cmd
- * @todo add run time duration
  */
 inline RunOutput run(std::vector<std::string> cmds) {
-	//cat cmds
-	std::string cmd = conToStr(cmds, " ");
-	//start a stopwatch to clock how long it took
-	njh::stopWatch watch;
-	redi::ipstream s(cmd, redi::ipstream::pstdout | redi::ipstream::pstderr);
-	//read stdout
-	std::stringstream outSS;
-	outSS << s.out().rdbuf();
-	auto out = bashCT::trimForNonTerminalOut(outSS.str());
-	trim(out);
-	//read stderr
-	std::stringstream errSS;
-	errSS << s.err().rdbuf();
-	auto err = bashCT::trimForNonTerminalOut(errSS.str());
-	trim(err);
-	s.close();
-	double rTime = watch.totalTime();
-	const int32_t errCode = s.rdbuf()->status();
-	if (s.rdbuf()->exited() && !errCode) {
-		return {true, 0, std::move(out), std::move(err), cmd, rTime};
-	}
-	return {false, errCode, std::move(out), std::move(err), cmd, rTime};
+	return run(cmds, RunPars());
 }
 
+/**@brief run the command in cmds externally, same as run() but terminal escape codes are left in the output
+ *
+ * @param cmds A vector of strings contains the command, content of cmds will be converted to a string with space delimited every string in cmds
+ * @return A RunOutPut object holding status and outputs of the externally ran cmd
+ */
 inline RunOutput runTest(std::vector<std::string> cmds) {
-	//cat cmds
-	std::string cmd = conToStr(cmds, " ");
-	//start a stopwatch to clock how long it took
-	njh::stopWatch watch;
-	redi::ipstream s(cmd, redi::ipstream::pstdout | redi::ipstream::pstderr);
-	//read stdout
-	std::stringstream outSS;
-	//read stderr
-	std::stringstream errSS;
-	char buf[1024];
-	std::streamsize n;
-	bool finished[2] = { false, false };
-	while (!finished[0] || !finished[1]) {
-		if (!finished[0]) {
-			while ((n = s.err().readsome(buf, sizeof(buf))) > 0) {
-				errSS.write(buf, n);
-			}
-			if (s.eof()) {
-				finished[0] = true;
-				if (!finished[1]) {
-					s.clear();
-				}
-			}
-		}
-		if (!finished[1]) {
-			while ((n = s.out().readsome(buf, sizeof(buf))) > 0) {
-				outSS.write(buf, n).flush();
-			}
-			if (s.eof()) {
-				finished[1] = true;
-				if (!finished[0]) {
-					s.clear();
-				}
-			}
-		}
-	}
-	auto out = outSS.str();
-	trim(out);
-
-	auto err = errSS.str();
-	trim(err);
-	s.close();
-
-	double rTime = watch.totalTime();
-	const int32_t errCode = s.rdbuf()->status();
-	if (s.rdbuf()->exited() && !errCode) {
-		return {true, 0, std::move(out), std::move(err), cmd, rTime};
-	}
-	return {false, errCode, std::move(out), std::move(err), cmd, rTime};
+	RunPars pars;
+	pars.removeTerminalCodes_ = false;
+	return run(cmds, pars);
 }
 
 
@@ -110,7 +59,7 @@ inline RunOutput runTest(std::vector<std::string> cmds) {
 /**@brief Run a vector of commands on multiple threads
  * Run multiple commands on the system in several threads, no safety checks on number of threads available or
  *  if commands would clash.  Will run all commands even if one fails, intention of this command is to run
- *  a bunch of small jobs at once
+ *  a bunch of small jobs at once, use JobScheduler for commands that depend on each other or need cpus and memory reserved
  *
  * @param cmds A vector of commands to run in parallel, no check is done to ensure they are not clashing
  * @param numThreads The number of threads to use
@@ -169,25 +118,46 @@ inline std::vector<njh::sys::RunOutput> runCmdsThreaded(
 	return ret;
 }
 
+/**@brief Run a vector of commands on multiple threads, see runCmdsThreaded(), and total up their time and resource use
+ *
+ * @param cmds A vector of commands to run in parallel, no check is done to ensure they are not clashing
+ * @param numThreads The number of threads to use
+ * @param verbose Whether to be print the command when it is being run
+ * @param debug Whether to just print the cmds and exit
+ * @param summary set to the totals over all the commands
+ * @return A vector njh::sys::RunOutput for status of the commands
+ */
+inline std::vector<njh::sys::RunOutput> runCmdsThreaded(
+		const std::vector<std::string> & cmds, uint32_t numThreads, bool verbose,
+		bool debug, RunSummary & summary) {
+	auto ret = runCmdsThreaded(cmds, numThreads, verbose, debug);
+	summary = RunSummary();
+	for (const auto & out : ret) {
+		summary.add(out);
+	}
+	return ret;
+}
+
 
-/**@brief return a bool of the success of calling system which on a command
+/**@brief return whether a command is in PATH, the same answer as which but looked up in process and cached, see findInPath()
  *
  * @param cmd the command to look for
- * @return a bool whether calling which on the command name was successful
+ * @return a bool whether the command was found
  */
 inline bool hasSysCommand(const std::string & cmd){
-	auto output = njh::sys::run({"which", cmd});
-	return output.success_;
+	return !findInPath(cmd).empty();
 }
 
-/**@brief return a the full output of calling system which on a command
+/**@brief return the result of looking for a command in PATH in the form calling which on it would give
  *
  * @param cmd the command to look for
- * @return the run output of the call to which, this way the path name and such can be recovered as well
+ * @return the full path in stdOut_ if found, success_ false and returnCode_ set as which's exit code of 1 would be if not
  */
 inline njh::sys::RunOutput hasSysCommandFullOut(const std::string & cmd){
-	auto output = njh::sys::run({"which", cmd});
-	return output;
+	njh::stopWatch watch;
+	auto fullPath = findInPath(cmd);
+	const bool found = !fullPath.empty();
+	return {found, found ? 0 : 256, fullPath, "", "which " + cmd, watch.totalTime()};
 }
 
 
@@ -270,8 +240,9 @@ inline bool requireExternalProgramsThrow(
 		const std::vector<std::string> & programs) {
 	bool failed = false;
 	std::stringstream ss;
+	const auto found = findInPath(programs);
 	for (const auto & program : programs) {
-		auto hasProgram = njh::sys::hasSysCommand(program);
+		auto hasProgram = !found.at(program).empty();
 		if (!hasProgram) {
 			failed = true;
 			if (stdoutTerminal()) {
@@ -3,7 +3,14 @@
 #include "njhcpp/utils/has_member.hpp"
 #include "njhcpp/utils/utils.hpp"
 #include "njhcpp/utils/vecUtils.hpp"
+#include "njhcpp/utils/simdUtils.hpp"
+#include "njhcpp/utils/StrViewTokenizer.hpp"
 #include "njhcpp/utils/stringUtils.hpp"
+#include "njhcpp/utils/AhoCorasick.hpp"
+#include "njhcpp/utils/StringReplacer.hpp"
+#include "njhcpp/utils/PatternSet.hpp"
+#include "njhcpp/utils/EditDistance.hpp"
+#include "njhcpp/utils/BKTree.hpp"
 #include "njhcpp/utils/typeUtils.hpp"
 #include "njhcpp/utils/lexical_cast.hpp"
 #include "njhcpp/utils/time.h"
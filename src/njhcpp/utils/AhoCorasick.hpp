@@ -0,0 +1,296 @@
+#pragma once
+/*
+ * AhoCorasick.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+
+namespace njh {
+
+/**@brief A compiled multi-pattern substring matcher, all patterns are searched for in a single pass over the input
+ *
+ * Patterns are added with addPattern() and then compile() builds a full deterministic automaton (goto and failure transitions folded together)
+ * over a reduced alphabet of only the bytes that actually appear in the patterns, so each input byte costs one table lookup
+ *
+ */
+class AhoCorasick {
+public:
+	/**@brief A match found while scanning
+	 *
+	 */
+	struct Match {
+		Match(uint32_t patIdx, size_t pos) :
+				patIdx_(patIdx), pos_(pos) {
+		}
+		uint32_t patIdx_; /**< the index of the pattern that matched (order added) */
+		size_t pos_; /**< the start position of the match in the input */
+	};
+
+	AhoCorasick() = default;
+
+	/**@brief Construct and compile with a set of patterns
+	 *
+	 * @param pats the patterns to search for, can't contain empty strings
+	 */
+	explicit AhoCorasick(const std::vector<std::string> & pats) {
+		for (const auto & pat : pats) {
+			addPattern(pat);
+		}
+		compile();
+	}
+
+	/**@brief Add a pattern, invalidates any previous compile
+	 *
+	 * @param pat the pattern to add, can't be empty
+	 * @return the index of the pattern, this is what will be reported when found
+	 */
+	uint32_t addPattern(const std::string & pat) {
+		if (pat.empty()) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: pattern can't be an empty string" };
+		}
+		pats_.emplace_back(pat);
+		compiled_ = false;
+		return pats_.size() - 1;
+	}
+
+	/**@brief Build the automaton from the patterns added so far
+	 *
+	 */
+	void compile() {
+		//reduce the alphabet down to the bytes that appear in the patterns, everything else shares class 0
+		classOf_.fill(0);
+		numClasses_ = 1;
+		maxPatLen_ = 0;
+		for (const auto & pat : pats_) {
+			maxPatLen_ = std::max<size_t>(maxPatLen_, pat.size());
+			for (const auto c : pat) {
+				auto & cls = classOf_[static_cast<uint8_t>(c)];
+				if (0 == cls) {
+					cls = numClasses_;
+					++numClasses_;
+				}
+			}
+		}
+		//trie
+		const uint32_t none = std::numeric_limits<uint32_t>::max();
+		delta_.assign(numClasses_, none);
+		std::vector<std::vector<uint32_t>> outs(1);
+		for (uint32_t patIdx = 0; patIdx < pats_.size(); ++patIdx) {
+			uint32_t state = 0;
+			for (const auto c : pats_[patIdx]) {
+				const size_t edge = static_cast<size_t>(state) * numClasses_ + classOf_[static_cast<uint8_t>(c)];
+				if (none == delta_[edge]) {
+					delta_[edge] = outs.size();
+					outs.emplace_back();
+					delta_.insert(delta_.end(), numClasses_, none);
+				}
+				state = delta_[edge];
+			}
+			outs[state].emplace_back(patIdx);
+		}
+		const uint32_t numStates = outs.size();
+		//failure links folded into the transition table in breadth first order
+		std::vector<uint32_t> fail(numStates, 0);
+		dictLink_.assign(numStates, 0);
+		std::deque<uint32_t> que;
+		for (uint32_t cls = 0; cls < numClasses_; ++cls) {
+			auto & next = delta_[cls];
+			if (none == next) {
+				next = 0;
+			} else {
+				que.emplace_back(next);
+			}
+		}
+		while (!que.empty()) {
+			const uint32_t state = que.front();
+			que.pop_front();
+			for (uint32_t cls = 0; cls < numClasses_; ++cls) {
+				auto & next = delta_[static_cast<size_t>(state) * numClasses_ + cls];
+				const uint32_t failNext = delta_[static_cast<size_t>(fail[state]) * numClasses_ + cls];
+				if (none == next) {
+					next = failNext;
+				} else {
+					fail[next] = failNext;
+					dictLink_[next] = outs[failNext].empty() ? dictLink_[failNext] : failNext;
+					que.emplace_back(next);
+				}
+			}
+		}
+		//flatten outputs
+		outStarts_.assign(numStates + 1, 0);
+		outPats_.clear();
+		for (uint32_t state = 0; state < numStates; ++state) {
+			outStarts_[state] = outPats_.size();
+			outPats_.insert(outPats_.end(), outs[state].begin(), outs[state].end());
+		}
+		outStarts_[numStates] = outPats_.size();
+		compiled_ = true;
+	}
+
+	/**@brief Whether compile() has been called since the last pattern was added
+	 *
+	 */
+	bool compiled() const {
+		return compiled_;
+	}
+
+	/**@brief The number of patterns added
+	 *
+	 */
+	uint32_t numberOfPatterns() const {
+		return pats_.size();
+	}
+
+	/**@brief Get the pattern at index patIdx
+	 *
+	 * @param patIdx the index of the pattern
+	 * @return the pattern
+	 */
+	const std::string & pattern(uint32_t patIdx) const {
+		return pats_[patIdx];
+	}
+
+	/**@brief Scan str and call func for every pattern occurrence in order of where the occurrences end
+	 *
+	 * @param str the string to scan
+	 * @param func a function taking the pattern index and the end position (not inclusive) of the match, return false to stop scanning
+	 */
+	template<typename FUNC>
+	void scan(std::string_view str, FUNC func) const {
+		checkCompiled(__PRETTY_FUNCTION__);
+		uint32_t state = 0;
+		for (size_t pos = 0; pos < str.size(); ++pos) {
+			state = delta_[static_cast<size_t>(state) * numClasses_ + classOf_[static_cast<uint8_t>(str[pos])]];
+			for (uint32_t outState = hasOutput(state) ? state : dictLink_[state];
+					0 != outState; outState = dictLink_[outState]) {
+				for (uint32_t outPos = outStarts_[outState]; outPos < outStarts_[outState + 1]; ++outPos) {
+					if (!func(outPats_[outPos], pos + 1)) {
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	/**@brief Scan str for non-overlapping occurrences, choosing left to right the leftmost occurrence and the longest pattern starting there
+	 * (the first added on ties), i.e. the matches a single pass find and replace would use
+	 *
+	 * @param str the string to scan
+	 * @param func a function taking the pattern index and the start position of the match, return false to stop scanning
+	 */
+	template<typename FUNC>
+	void scanLeftmostLongest(std::string_view str, FUNC func) const {
+		checkCompiled(__PRETTY_FUNCTION__);
+		if (pats_.empty()) {
+			return;
+		}
+		//ring buffer of the longest match starting at each position still in the window of maxPatLen_ positions
+		std::vector<uint32_t> bestLen(maxPatLen_, 0);
+		std::vector<uint32_t> bestPat(maxPatLen_, 0);
+		size_t next = 0; /**< the next start position that hasn't been decided yet*/
+		//decide the starts before end, a match taken at next skips past it
+		auto resolve = [&](size_t end) {
+			while (next < end) {
+				const size_t slot = next % maxPatLen_;
+				if (0 == bestLen[slot]) {
+					++next;
+				} else {
+					if (!func(bestPat[slot], next)) {
+						return false;
+					}
+					next += bestLen[slot];
+				}
+			}
+			return true;
+		};
+		uint32_t state = 0;
+		for (size_t pos = 0; pos < str.size(); ++pos) {
+			bestLen[pos % maxPatLen_] = 0;
+			state = delta_[static_cast<size_t>(state) * numClasses_ + classOf_[static_cast<uint8_t>(str[pos])]];
+			for (uint32_t outState = hasOutput(state) ? state : dictLink_[state];
+					0 != outState; outState = dictLink_[outState]) {
+				for (uint32_t outPos = outStarts_[outState]; outPos < outStarts_[outState + 1]; ++outPos) {
+					const uint32_t patIdx = outPats_[outPos];
+					const uint32_t len = pats_[patIdx].size();
+					const size_t start = pos + 1 - len;
+					if (start < next) {
+						continue;
+					}
+					const size_t slot = start % maxPatLen_;
+					if (len > bestLen[slot] || (len == bestLen[slot] && patIdx < bestPat[slot])) {
+						bestLen[slot] = len;
+						bestPat[slot] = patIdx;
+					}
+				}
+			}
+			//no match ending later can start at or before pos + 1 - maxPatLen_
+			if (pos + 2 > maxPatLen_ && !resolve(pos + 2 - maxPatLen_)) {
+				return;
+			}
+		}
+		resolve(str.size());
+	}
+
+	/**@brief Get all occurrences of all patterns in str, overlapping occurrences are all reported
+	 *
+	 * @param str the string to search
+	 * @return the matches in order of where the matches end
+	 */
+	std::vector<Match> findAll(std::string_view str) const {
+		std::vector<Match> ret;
+		scan(str, [this,&ret](uint32_t patIdx, size_t end) {
+			ret.emplace_back(patIdx, end - pats_[patIdx].size());
+			return true;
+		});
+		return ret;
+	}
+
+	/**@brief Whether str contains any of the patterns
+	 *
+	 * @param str the string to search
+	 * @return true if at least one pattern occurs in str
+	 */
+	bool containsAny(std::string_view str) const {
+		bool found = false;
+		scan(str, [&found](uint32_t, size_t) {
+			found = true;
+			return false;
+		});
+		return found;
+	}
+
+private:
+	std::vector<std::string> pats_; /**< the patterns searched for */
+	std::array<uint32_t, 256> classOf_ { }; /**< byte to alphabet class */
+	uint32_t numClasses_ = 1; /**< number of alphabet classes, class 0 is every byte not in a pattern*/
+	size_t maxPatLen_ = 0; /**< the length of the longest pattern */
+	std::vector<uint32_t> delta_; /**< the transition table, numStates x numClasses_ */
+	std::vector<uint32_t> dictLink_; /**< the nearest state along the failure links that has output, 0 for none */
+	std::vector<uint32_t> outStarts_; /**< offsets into outPats_ for each state */
+	std::vector<uint32_t> outPats_; /**< pattern indexes ending at each state */
+	bool compiled_ = false; /**< whether the automaton is up to date*/
+
+	bool hasOutput(uint32_t state) const {
+		return outStarts_[state] != outStarts_[state + 1];
+	}
+
+	void checkCompiled(const char * funcName) const {
+		if (!compiled_) {
+			throw std::runtime_error { std::string(funcName) + ", error: patterns need to be compiled first, call compile()" };
+		}
+	}
+};
+
+}  // namespace njh
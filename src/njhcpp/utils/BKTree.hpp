@@ -0,0 +1,193 @@
+#pragma once
+/*
+ * BKTree.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+#include "njhcpp/utils/EditDistance.hpp"
+
+namespace njh {
+
+/**@brief A Burkhard-Keller tree of words under Levenshtein distance for finding the closest words to a query (e.g. spelling suggestions)
+ * without comparing against every word, build once and query many times
+ *
+ * The triangle inequality is used to skip whole subtrees, Damerau (optimal string alignment) distance isn't a metric so isn't used here
+ *
+ */
+class BKTree {
+public:
+	/**@brief A word found by a search
+	 *
+	 */
+	struct Match {
+		Match(uint32_t wordIdx, uint32_t dist) :
+				wordIdx_(wordIdx), dist_(dist) {
+		}
+		uint32_t wordIdx_; /**< the index of the word (order added) */
+		uint32_t dist_; /**< the edit distance to the query */
+	};
+
+	BKTree() = default;
+
+	/**@brief Construct with words
+	 *
+	 * @param words the words to add
+	 */
+	template<typename CON>
+	explicit BKTree(const CON & words) {
+		for (const auto & word : words) {
+			add(word);
+		}
+	}
+
+	/**@brief Add a word, duplicates are ignored
+	 *
+	 * @param word the word to add
+	 * @return false if the word was already in the tree
+	 */
+	bool add(std::string_view word) {
+		if (nodes_.empty()) {
+			nodes_.emplace_back(word);
+			return true;
+		}
+		const EditDistancePattern pattern(word);
+		uint32_t nodePos = 0;
+		while (true) {
+			const uint32_t dist = pattern.distance(nodes_[nodePos].word_);
+			if (0 == dist) {
+				return false;
+			}
+			auto & children = nodes_[nodePos].children_;
+			auto child = std::find_if(children.begin(), children.end(),
+					[dist](const std::pair<uint32_t, uint32_t> & edge) {return edge.first == dist;});
+			if (children.end() == child) {
+				const uint32_t newPos = nodes_.size();
+				children.emplace_back(dist, newPos);
+				//children is invalidated by the emplace into nodes_
+				nodes_.emplace_back(word);
+				return true;
+			}
+			nodePos = child->second;
+		}
+	}
+
+	size_t size() const {
+		return nodes_.size();
+	}
+
+	bool empty() const {
+		return nodes_.empty();
+	}
+
+	/**@brief Get the word at index wordIdx
+	 *
+	 * @param wordIdx the index of the word
+	 * @return the word
+	 */
+	const std::string & word(uint32_t wordIdx) const {
+		return nodes_[wordIdx].word_;
+	}
+
+	/**@brief Get all words within maxDist edits of query
+	 *
+	 * @param query the string to search for
+	 * @param maxDist the max edit distance
+	 * @return the matches sorted by distance and then by the order the words were added
+	 */
+	std::vector<Match> search(std::string_view query, uint32_t maxDist) const {
+		std::vector<Match> ret;
+		if (nodes_.empty()) {
+			return ret;
+		}
+		const EditDistancePattern pattern(query);
+		std::vector<uint32_t> toVisit { 0 };
+		while (!toVisit.empty()) {
+			const uint32_t nodePos = toVisit.back();
+			toVisit.pop_back();
+			const uint32_t dist = pattern.distance(nodes_[nodePos].word_);
+			if (dist <= maxDist) {
+				ret.emplace_back(nodePos, dist);
+			}
+			for (const auto & child : nodes_[nodePos].children_) {
+				if (static_cast<uint64_t>(child.first) + maxDist >= dist
+						&& child.first <= static_cast<uint64_t>(dist) + maxDist) {
+					toVisit.emplace_back(child.second);
+				}
+			}
+		}
+		sortMatches(ret);
+		return ret;
+	}
+
+	/**@brief Get the k closest words to query
+	 *
+	 * @param query the string to search for
+	 * @param k the number of words to return
+	 * @param maxDist only return words within this many edits
+	 * @return up to k matches sorted by distance and then by the order the words were added
+	 */
+	std::vector<Match> closest(std::string_view query, uint32_t k,
+			uint32_t maxDist = std::numeric_limits<uint32_t>::max()) const {
+		std::vector<Match> ret;
+		if (nodes_.empty() || 0 == k) {
+			return ret;
+		}
+		const EditDistancePattern pattern(query);
+		//the current k best, the search radius shrinks to the worst of them once there are k
+		uint32_t radius = maxDist;
+		std::vector<uint32_t> toVisit { 0 };
+		while (!toVisit.empty()) {
+			const uint32_t nodePos = toVisit.back();
+			toVisit.pop_back();
+			const uint32_t dist = pattern.distance(nodes_[nodePos].word_);
+			if (dist <= radius) {
+				ret.emplace_back(nodePos, dist);
+				if (ret.size() > k) {
+					sortMatches(ret);
+					ret.pop_back();
+				}
+				if (ret.size() == k) {
+					radius = std::min(radius, std::max_element(ret.begin(), ret.end(),
+							[](const Match & a, const Match & b) {return a.dist_ < b.dist_;})->dist_);
+				}
+			}
+			for (const auto & child : nodes_[nodePos].children_) {
+				if (static_cast<uint64_t>(child.first) + radius >= dist
+						&& child.first <= static_cast<uint64_t>(dist) + radius) {
+					toVisit.emplace_back(child.second);
+				}
+			}
+		}
+		sortMatches(ret);
+		return ret;
+	}
+
+private:
+	struct Node {
+		explicit Node(std::string_view word) :
+				word_(word) {
+		}
+		std::string word_;
+		std::vector<std::pair<uint32_t, uint32_t>> children_; /**< edit distance to the child and the child's index */
+	};
+
+	std::vector<Node> nodes_; /**< node 0 is the root, nodes are in the order the words were added */
+
+	static void sortMatches(std::vector<Match> & matches) {
+		std::sort(matches.begin(), matches.end(), [](const Match & a, const Match & b) {
+			return a.dist_ == b.dist_ ? a.wordIdx_ < b.wordIdx_ : a.dist_ < b.dist_;
+		});
+	}
+};
+
+}  // namespace njh
@@ -0,0 +1,143 @@
+#pragma once
+/*
+ * EditDistance.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+
+namespace njh {
+
+/**@brief A precomputed pattern for computing the edit distance from one string to many others
+ *
+ * Patterns of up to 64 characters use the bit-parallel algorithm of Myers (1999) as formulated by Hyyro, with Hyyro's (2003)
+ * extension for adjacent transpositions (optimal string alignment distance) when transpositions are on, so each character
+ * of the other string costs a handful of word operations. Longer patterns fall back on the two row dynamic programming.
+ *
+ */
+class EditDistancePattern {
+public:
+	/**@brief Construct with the pattern
+	 *
+	 * @param pattern the string to compare others to
+	 * @param transpositions whether swapping two adjacent characters counts as one edit (Damerau/optimal string alignment) rather than two
+	 */
+	explicit EditDistancePattern(std::string_view pattern, bool transpositions = false) :
+			pattern_(pattern), transpositions_(transpositions) {
+		if (pattern_.size() <= 64) {
+			peq_.fill(0);
+			for (size_t pos = 0; pos < pattern_.size(); ++pos) {
+				peq_[static_cast<uint8_t>(pattern_[pos])] |= uint64_t(1) << pos;
+			}
+		}
+	}
+
+	/**@brief Get the number of edits (insertions, deletions, substitutions and, if on, adjacent transpositions) to turn the pattern into text
+	 *
+	 * @param text the string to compare to
+	 * @return the edit distance
+	 */
+	uint32_t distance(std::string_view text) const {
+		if (pattern_.empty()) {
+			return text.size();
+		}
+		if (text.empty()) {
+			return pattern_.size();
+		}
+		if (pattern_.size() > 64) {
+			return distanceRows(text);
+		}
+		const uint32_t len = pattern_.size();
+		const uint64_t lastBit = uint64_t(1) << (len - 1);
+		uint64_t vp = len == 64 ? ~uint64_t(0) : (uint64_t(1) << len) - 1;
+		uint64_t vn = 0;
+		uint64_t d0 = 0;
+		uint64_t prevEq = 0;
+		uint32_t score = len;
+		for (const auto c : text) {
+			const uint64_t eq = peq_[static_cast<uint8_t>(c)];
+			//a transposition is where the previous column's diagonal wasn't free and the characters swap
+			const uint64_t transposed = transpositions_ ? (((~d0) & eq) << 1) & prevEq : 0;
+			d0 = (((eq & vp) + vp) ^ vp) | eq | vn | transposed;
+			prevEq = eq;
+			uint64_t hp = vn | ~(d0 | vp);
+			const uint64_t hn = vp & d0;
+			if (hp & lastBit) {
+				++score;
+			} else if (hn & lastBit) {
+				--score;
+			}
+			hp = (hp << 1) | 1;
+			const uint64_t hnShifted = hn << 1;
+			vp = hnShifted | ~(d0 | hp);
+			vn = hp & d0;
+		}
+		return score;
+	}
+
+	const std::string & pattern() const {
+		return pattern_;
+	}
+
+	bool transpositions() const {
+		return transpositions_;
+	}
+
+private:
+	std::string pattern_; /**< the pattern */
+	bool transpositions_ = false; /**< whether adjacent transpositions count as one edit */
+	std::array<uint64_t, 256> peq_; /**< for each character the bit mask of its positions in the pattern */
+
+	uint32_t distanceRows(std::string_view text) const {
+		//rows over the text, three kept for transpositions
+		std::vector<uint32_t> prev2(text.size() + 1), prev(text.size() + 1), cur(text.size() + 1);
+		for (size_t j = 0; j <= text.size(); ++j) {
+			prev[j] = j;
+		}
+		for (size_t i = 1; i <= pattern_.size(); ++i) {
+			cur[0] = i;
+			for (size_t j = 1; j <= text.size(); ++j) {
+				const uint32_t sub = prev[j - 1] + (pattern_[i - 1] == text[j - 1] ? 0 : 1);
+				cur[j] = std::min( { prev[j] + 1, cur[j - 1] + 1, sub });
+				if (transpositions_ && i > 1 && j > 1 && pattern_[i - 1] == text[j - 2]
+						&& pattern_[i - 2] == text[j - 1]) {
+					cur[j] = std::min(cur[j], prev2[j - 2] + 1);
+				}
+			}
+			std::swap(prev2, prev);
+			std::swap(prev, cur);
+		}
+		return prev[text.size()];
+	}
+};
+
+/**@brief The Levenshtein distance between two strings, use njh::EditDistancePattern directly when comparing one string to many
+ *
+ * @param a the first string
+ * @param b the second string
+ * @return the number of insertions, deletions and substitutions to turn a into b
+ */
+inline uint32_t levenshteinDistance(std::string_view a, std::string_view b) {
+	//the shorter string as the pattern so more fit in the 64 bit fast path
+	return a.size() <= b.size() ? EditDistancePattern(a).distance(b) : EditDistancePattern(b).distance(a);
+}
+
+/**@brief The Damerau-Levenshtein (optimal string alignment) distance between two strings, i.e. Levenshtein where swapping adjacent characters is one edit
+ *
+ * @param a the first string
+ * @param b the second string
+ * @return the number of insertions, deletions, substitutions and adjacent transpositions to turn a into b
+ */
+inline uint32_t damerauLevenshteinDistance(std::string_view a, std::string_view b) {
+	return a.size() <= b.size() ? EditDistancePattern(a, true).distance(b) : EditDistancePattern(b, true).distance(a);
+}
+
+}  // namespace njh
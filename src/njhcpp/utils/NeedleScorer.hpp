@@ -0,0 +1,230 @@
+#pragma once
+/*
+ * NeedleScorer.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cstdlib> //std::abs
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace njh {
+
+/**@brief Score-only global alignment with affine gaps (end gaps penalized), the scoring behind njh::needleScore()
+ *
+ * Only the score is computed so only two rows of the three (up, left, diagonal) matrices are kept. Longer inputs are done
+ * with an anti-diagonal SSE2 kernel on 16 bit scores, eight cells at a time. The buffers are kept between calls
+ * so one scorer should be reused for scoring one query against many targets, one scorer per thread.
+ *
+ */
+class NeedleScorer {
+public:
+	/**@brief Construct with the default scoring of njh::needleScore(), match 2, mismatch -2, gap open 5, gap extend 1
+	 *
+	 */
+	NeedleScorer() = default;
+
+	/**@brief Construct with scoring
+	 *
+	 * @param match the score for matching characters
+	 * @param mismatch the score for mismatching characters (normally negative)
+	 * @param gapOpen the penalty for the first character of a gap (positive)
+	 * @param gapExtend the penalty for each further character of a gap (positive)
+	 */
+	NeedleScorer(int32_t match, int32_t mismatch, int32_t gapOpen, int32_t gapExtend) :
+			match_(match), mismatch_(mismatch), gapOpen_(gapOpen), gapExtend_(gapExtend) {
+	}
+
+	int32_t match_ = 2; /**< the score for matching characters*/
+	int32_t mismatch_ = -2; /**< the score for mismatching characters*/
+	int32_t gapOpen_ = 5; /**< the penalty for opening a gap*/
+	int32_t gapExtend_ = 1; /**< the penalty for extending a gap*/
+
+	/**@brief Score the global alignment of two strings, 0 if either is empty
+	 *
+	 * @param objA first string to compare
+	 * @param objB second string to compare
+	 * @return the alignment score
+	 */
+	int32_t score(std::string_view objA, std::string_view objB) {
+		if (objA.empty() || objB.empty()) {
+			return 0;
+		}
+#if defined(__SSE2__)
+		if (useSimd(objA.size(), objB.size())) {
+			return scoreAntiDiagonal(objA, objB);
+		}
+#endif
+		return scoreRows(objA, objB);
+	}
+
+	/**@brief Score one query against many targets
+	 *
+	 * @param query the string to compare
+	 * @param targets a container of strings (anything convertible to std::string_view)
+	 * @return the scores in the order of targets
+	 */
+	template<typename CON>
+	std::vector<int32_t> scoreAll(std::string_view query, const CON & targets) {
+		std::vector<int32_t> ret;
+		ret.reserve(targets.size());
+		for (const auto & target : targets) {
+			ret.emplace_back(score(query, target));
+		}
+		return ret;
+	}
+
+	/**@brief Get the target with the highest score to the query, the first one on ties
+	 *
+	 * @param query the string to compare
+	 * @param targets a container of strings (anything convertible to std::string_view)
+	 * @return the index of the best target and its score, targets.size() and 0 if targets is empty
+	 */
+	template<typename CON>
+	std::pair<size_t, int32_t> bestMatch(std::string_view query, const CON & targets) {
+		std::pair<size_t, int32_t> ret { targets.size(), 0 };
+		size_t pos = 0;
+		for (const auto & target : targets) {
+			const int32_t currentScore = score(query, target);
+			if (targets.size() == ret.first || currentScore > ret.second) {
+				ret = {pos, currentScore};
+			}
+			++pos;
+		}
+		return ret;
+	}
+
+private:
+	static constexpr int32_t negInf_ = std::numeric_limits<int32_t>::min() / 4; /**< for cells that can't be reached*/
+
+	std::vector<int32_t> rows_; /**< two rows each of up, left and diagonal scores*/
+
+#if defined(__SSE2__)
+	static constexpr int16_t negInf16_ = -16000; /**< for cells that can't be reached in the 16 bit kernel*/
+	std::vector<int16_t> diags_; /**< three anti-diagonals each of up, left and diagonal scores*/
+	std::string padA_; /**< objA padded so 8 byte loads past the end are safe*/
+	std::string revB_; /**< objB reversed and padded so a diagonal reads it forward*/
+
+	bool useSimd(size_t lenA, size_t lenB) const {
+		//16 bit scores need the most negative reachable score to stay well above the unreachable value
+		const int64_t maxPenalty = std::max<int64_t>( { gapExtend_, gapOpen_, std::abs(mismatch_), std::abs(match_) });
+		return std::min(lenA, lenB) >= 16
+				&& (3 * gapOpen_ + static_cast<int64_t>(lenA + lenB) * maxPenalty) < 12000
+				&& static_cast<int64_t>(std::min(lenA, lenB)) * std::abs(match_) < 12000;
+	}
+
+	int32_t scoreAntiDiagonal(std::string_view objA, std::string_view objB) {
+		const size_t lenA = objA.size();
+		const size_t lenB = objB.size();
+		const size_t diagSize = lenA + 1 + 8;
+		diags_.assign(9 * diagSize, 0);
+		padA_.assign(objA.begin(), objA.end());
+		padA_.append(16, '\0');
+		revB_.assign(objB.rbegin(), objB.rend());
+		revB_.append(16, '\0');
+		auto diag = [this, diagSize](uint32_t state, size_t d) {
+			//state 0 up, 1 left, 2 diagonal
+			return diags_.data() + (state * 3 + d % 3) * diagSize;
+		};
+		const __m128i gapOpen = _mm_set1_epi16(static_cast<int16_t>(gapOpen_));
+		const __m128i gapExtend = _mm_set1_epi16(static_cast<int16_t>(gapExtend_));
+		const __m128i mismatch = _mm_set1_epi16(static_cast<int16_t>(mismatch_));
+		const __m128i matchBonus = _mm_set1_epi16(static_cast<int16_t>(match_ - mismatch_));
+		for (size_t d = 1; d <= lenA + lenB; ++d) {
+			int16_t * curU = diag(0, d);
+			int16_t * curL = diag(1, d);
+			int16_t * curD = diag(2, d);
+			const int16_t * prevU = diag(0, d - 1);
+			const int16_t * prevL = diag(1, d - 1);
+			const int16_t * prevD = diag(2, d - 1);
+			const int16_t * prev2U = diag(0, d + 1);
+			const int16_t * prev2L = diag(1, d + 1);
+			const int16_t * prev2D = diag(2, d + 1);
+			const size_t lo = d > lenB ? d - lenB : 1;
+			const size_t hi = std::min(lenA, d - 1);
+			for (size_t i = lo; i <= hi; i += 8) {
+				const __m128i up = _mm_max_epi16(
+						_mm_subs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(prevU + i - 1)), gapExtend),
+						_mm_subs_epi16(_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(prevL + i - 1)),
+								_mm_loadu_si128(reinterpret_cast<const __m128i *>(prevD + i - 1))), gapOpen));
+				const __m128i left = _mm_max_epi16(
+						_mm_subs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(prevL + i)), gapExtend),
+						_mm_subs_epi16(_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(prevU + i)),
+								_mm_loadu_si128(reinterpret_cast<const __m128i *>(prevD + i))), gapOpen));
+				//cell (i, d - i) compares objA[i - 1] to objB[d - i - 1] which is revB_[lenB - d + i]
+				const __m128i eq8 = _mm_cmpeq_epi8(
+						_mm_loadl_epi64(reinterpret_cast<const __m128i *>(padA_.data() + i - 1)),
+						_mm_loadl_epi64(reinterpret_cast<const __m128i *>(revB_.data() + lenB - d + i)));
+				const __m128i matchScore = _mm_add_epi16(mismatch, _mm_and_si128(_mm_unpacklo_epi8(eq8, eq8), matchBonus));
+				const __m128i prevBest = _mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(prev2U + i - 1)),
+						_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(prev2L + i - 1)),
+								_mm_loadu_si128(reinterpret_cast<const __m128i *>(prev2D + i - 1))));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(curU + i), up);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(curL + i), left);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(curD + i), _mm_adds_epi16(prevBest, matchScore));
+			}
+			//the edges, written after the interior since the last block writes past hi
+			const int16_t edgeGap = static_cast<int16_t>(-gapOpen_ - static_cast<int32_t>(d - 1) * gapExtend_);
+			if (d <= lenB) {
+				curU[0] = negInf16_;
+				curL[0] = edgeGap;
+				curD[0] = negInf16_;
+			}
+			if (d <= lenA) {
+				curU[d] = edgeGap;
+				curL[d] = negInf16_;
+				curD[d] = negInf16_;
+			}
+		}
+		const size_t last = lenA + lenB;
+		return std::max( { diag(0, last)[lenA], diag(1, last)[lenA], diag(2, last)[lenA] });
+	}
+#endif
+
+	int32_t scoreRows(std::string_view objA, std::string_view objB) {
+		const size_t lenB = objB.size();
+		const size_t rowSize = lenB + 1;
+		rows_.resize(6 * rowSize);
+		int32_t * prevU = rows_.data();
+		int32_t * prevL = prevU + rowSize;
+		int32_t * prevD = prevL + rowSize;
+		int32_t * curU = prevD + rowSize;
+		int32_t * curL = curU + rowSize;
+		int32_t * curD = curL + rowSize;
+		//first row, only reachable by a gap in objA
+		prevU[0] = prevL[0] = prevD[0] = 0;
+		for (size_t j = 1; j <= lenB; ++j) {
+			prevU[j] = negInf_;
+			prevL[j] = -gapOpen_ - static_cast<int32_t>(j - 1) * gapExtend_;
+			prevD[j] = negInf_;
+		}
+		for (size_t i = 1; i <= objA.size(); ++i) {
+			curU[0] = -gapOpen_ - static_cast<int32_t>(i - 1) * gapExtend_;
+			curL[0] = negInf_;
+			curD[0] = negInf_;
+			const char aChar = objA[i - 1];
+			for (size_t j = 1; j <= lenB; ++j) {
+				curU[j] = std::max(prevU[j] - gapExtend_, std::max(prevL[j], prevD[j]) - gapOpen_);
+				curL[j] = std::max(curL[j - 1] - gapExtend_, std::max(curU[j - 1], curD[j - 1]) - gapOpen_);
+				curD[j] = (aChar == objB[j - 1] ? match_ : mismatch_)
+						+ std::max( { prevU[j - 1], prevL[j - 1], prevD[j - 1] });
+			}
+			std::swap(prevU, curU);
+			std::swap(prevL, curL);
+			std::swap(prevD, curD);
+		}
+		return std::max( { prevU[lenB], prevL[lenB], prevD[lenB] });
+	}
+};
+
+}  // namespace njh
@@ -0,0 +1,428 @@
+#pragma once
+/*
+ * PatternSet.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <regex>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include "njhcpp/utils/AhoCorasick.hpp"
+
+namespace njh {
+
+/**@brief A compiled set of include/exclude substrings and regex patterns to filter many strings against (e.g. file names)
+ *
+ * Has the same semantics as using checkForSubStrs(), checkForPats() and checkForPatsExclude() together, a string passes if it contains all the
+ * include substrings, fully matches all the include regex patterns and doesn't contain any exclude substring or fully match any of the exclude regex patterns.
+ *
+ * All substrings go into one AhoCorasick automaton so they are all checked in one pass, regex patterns that are just literals with optional
+ * leading/trailing .* and . wildcards (e.g. ".*\\.fastq$", "^sample.*") are turned into prefix/suffix/exact/substring checks, and only the regex patterns
+ * that are left are run with std::regex (all the exclude patterns combined into one regex)
+ *
+ */
+class PatternSet {
+public:
+	PatternSet() = default;
+
+	/**@brief Construct with patterns and compile
+	 *
+	 * @param includeSubStrs substrings that all have to be in the string
+	 * @param excludeSubStrs substrings that can't be in the string
+	 * @param includePats regex patterns that all have to match the whole string
+	 * @param excludePats regex patterns that can't match the whole string
+	 */
+	PatternSet(const std::vector<std::string> & includeSubStrs,
+			const std::vector<std::string> & excludeSubStrs,
+			const std::vector<std::string> & includePats = std::vector<std::string>{},
+			const std::vector<std::string> & excludePats = std::vector<std::string>{}) :
+			includeSubStrs_(includeSubStrs), excludeSubStrs_(excludeSubStrs),
+			includePats_(includePats), excludePats_(excludePats) {
+		compile();
+	}
+
+	/**@brief Add a substring that has to be in the string, call compile() before matching again
+	 *
+	 * @param subStr the substring
+	 */
+	void addIncludeSubStr(const std::string & subStr) {
+		includeSubStrs_.emplace_back(subStr);
+		compiled_ = false;
+	}
+
+	/**@brief Add a substring that can't be in the string, call compile() before matching again
+	 *
+	 * @param subStr the substring
+	 */
+	void addExcludeSubStr(const std::string & subStr) {
+		excludeSubStrs_.emplace_back(subStr);
+		compiled_ = false;
+	}
+
+	/**@brief Add a regex pattern that has to match the whole string, call compile() before matching again
+	 *
+	 * @param pat the regex pattern (ECMAScript)
+	 */
+	void addIncludePat(const std::string & pat) {
+		includePats_.emplace_back(pat);
+		compiled_ = false;
+	}
+
+	/**@brief Add a regex pattern that can't match the whole string, call compile() before matching again
+	 *
+	 * @param pat the regex pattern (ECMAScript)
+	 */
+	void addExcludePat(const std::string & pat) {
+		excludePats_.emplace_back(pat);
+		compiled_ = false;
+	}
+
+	/**@brief Whether there are no patterns at all, everything will pass
+	 *
+	 */
+	bool empty() const {
+		return includeSubStrs_.empty() && excludeSubStrs_.empty()
+				&& includePats_.empty() && excludePats_.empty();
+	}
+
+	/**@brief Compile all the patterns added so far
+	 *
+	 */
+	void compile() {
+		auto compiledPatterns = CompiledPatterns();
+		for (const auto & subStr : includeSubStrs_) {
+			//an empty substring is in everything
+			if (!subStr.empty()) {
+				compiledPatterns.addSubStr(subStr, true, false);
+			}
+		}
+		for (const auto & subStr : excludeSubStrs_) {
+			if (subStr.empty()) {
+				compiledPatterns.excludeAll_ = true;
+			} else {
+				compiledPatterns.addSubStr(subStr, false, false);
+			}
+		}
+		for (const auto & pat : includePats_) {
+			compiledPatterns.addPat(pat, true);
+		}
+		std::vector<std::string> regexExcludes;
+		std::string combinedExclude;
+		bool canCombine = true;
+		for (const auto & pat : excludePats_) {
+			if (!compiledPatterns.addPat(pat, false)) {
+				//back references would be renumbered in a combined pattern
+				if (std::regex_search(pat, std::regex { R"(\\[1-9])" })) {
+					canCombine = false;
+				}
+				if (!combinedExclude.empty()) {
+					combinedExclude += "|";
+				}
+				combinedExclude += "(?:" + pat + ")";
+				regexExcludes.emplace_back(pat);
+			}
+		}
+		if (canCombine && !combinedExclude.empty()) {
+			compiledPatterns.excludeRegexes_.emplace_back(combinedExclude);
+		} else {
+			for (const auto & pat : regexExcludes) {
+				compiledPatterns.excludeRegexes_.emplace_back(pat);
+			}
+		}
+		compiledPatterns.subStrs_.compile();
+		compiled_ = true;
+		compiledPatterns_ = std::move(compiledPatterns);
+	}
+
+	/**@brief Check str against all the patterns
+	 *
+	 * @param str the string to check
+	 * @return true if str contains/matches all the include patterns and none of the exclude patterns
+	 */
+	bool matches(std::string_view str) const {
+		if (!compiled_) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: patterns need to be compiled first, call compile()" };
+		}
+		const auto & comp = compiledPatterns_;
+		if (comp.excludeAll_) {
+			return false;
+		}
+		//. and .* don't match line terminators so if there are any the converted regex patterns have to be run as regex
+		const bool fullRegex = comp.hasPats_ && std::string_view::npos != str.find_first_of("\r\n");
+		if (comp.subStrs_.numberOfPatterns() > 0) {
+			const uint32_t numRequired = comp.numRequired_ - (fullRegex ? comp.numRequiredFromPats_ : 0);
+			uint64_t foundMask = 0;
+			std::vector<bool> foundLarge;
+			if (comp.numRequired_ > 64) {
+				foundLarge.assign(comp.numRequired_, false);
+			}
+			uint32_t foundCount = 0;
+			bool excluded = false;
+			comp.subStrs_.scan(str, [&](uint32_t patIdx, size_t) {
+				const auto & role = comp.subStrRoles_[patIdx];
+				if (fullRegex && role.fromPat_) {
+					return true;
+				}
+				if (!role.include_) {
+					excluded = true;
+					return false;
+				}
+				bool alreadyFound = false;
+				if (foundLarge.empty()) {
+					alreadyFound = foundMask & (uint64_t(1) << role.requiredIdx_);
+					foundMask |= (uint64_t(1) << role.requiredIdx_);
+				} else {
+					alreadyFound = foundLarge[role.requiredIdx_];
+					foundLarge[role.requiredIdx_] = true;
+				}
+				if (!alreadyFound) {
+					++foundCount;
+				}
+				//can stop early if there are no exclude patterns to worry about
+				return !(foundCount == numRequired && !comp.hasExcludeSubStrs_);
+			});
+			if (excluded || foundCount != numRequired) {
+				return false;
+			}
+		}
+		if (fullRegex) {
+			for (const auto & pat : comp.simpleFallbacks_) {
+				if (std::regex_match(str.begin(), str.end(), pat.second) != pat.first) {
+					return false;
+				}
+			}
+		} else {
+			for (const auto & simple : comp.simplePats_) {
+				if (simple.matches(str) != simple.include_) {
+					return false;
+				}
+			}
+		}
+		for (const auto & pat : comp.includeRegexes_) {
+			if (!std::regex_match(str.begin(), str.end(), pat)) {
+				return false;
+			}
+		}
+		for (const auto & pat : comp.excludeRegexes_) {
+			if (std::regex_match(str.begin(), str.end(), pat)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**@brief Check whether a regex pattern will be run as a simple literal check rather than with std::regex
+	 *
+	 * @param pat the regex pattern
+	 * @return true if the pattern is only a literal with optional . wildcards, leading/trailing .* and ^/$ anchors
+	 */
+	static bool isSimplePat(const std::string & pat) {
+		SimplePat simple;
+		return parseSimplePat(pat, simple);
+	}
+
+private:
+	/**@brief A regex pattern that is just a literal with possible . wildcards anchored to the start/end or neither
+	 *
+	 */
+	struct SimplePat {
+		enum class Kind {
+			EXACT, PREFIX, SUFFIX, CONTAINS
+		};
+		Kind kind_ = Kind::EXACT;
+		std::string body_;
+		std::vector<bool> wild_;
+		bool include_ = true;
+
+		bool matchesAt(std::string_view str, size_t pos) const {
+			for (size_t bodyPos = 0; bodyPos < body_.size(); ++bodyPos) {
+				if (!wild_[bodyPos] && str[pos + bodyPos] != body_[bodyPos]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool matches(std::string_view str) const {
+			if (str.size() < body_.size()) {
+				return false;
+			}
+			switch (kind_) {
+			case Kind::EXACT:
+				return str.size() == body_.size() && matchesAt(str, 0);
+			case Kind::PREFIX:
+				return matchesAt(str, 0);
+			case Kind::SUFFIX:
+				return matchesAt(str, str.size() - body_.size());
+			case Kind::CONTAINS:
+				for (size_t pos = 0; pos + body_.size() <= str.size(); ++pos) {
+					if (matchesAt(str, pos)) {
+						return true;
+					}
+				}
+				return false;
+			}
+			return false;
+		}
+	};
+
+	/**@brief The role of a substring in the automaton
+	 *
+	 */
+	struct SubStrRole {
+		bool include_ = true;
+		bool fromPat_ = false;
+		uint32_t requiredIdx_ = 0;
+	};
+
+	/**@brief Everything built by compile()
+	 *
+	 */
+	struct CompiledPatterns {
+		AhoCorasick subStrs_;
+		std::vector<SubStrRole> subStrRoles_;
+		uint32_t numRequired_ = 0;
+		uint32_t numRequiredFromPats_ = 0;
+		bool hasExcludeSubStrs_ = false;
+		bool hasPats_ = false;
+		bool excludeAll_ = false;
+		std::vector<SimplePat> simplePats_;
+		std::vector<std::pair<bool, std::regex>> simpleFallbacks_;
+		std::vector<std::regex> includeRegexes_;
+		std::vector<std::regex> excludeRegexes_;
+
+		void addSubStr(const std::string & subStr, bool include, bool fromPat) {
+			subStrs_.addPattern(subStr);
+			SubStrRole role;
+			role.include_ = include;
+			role.fromPat_ = fromPat;
+			if (include) {
+				role.requiredIdx_ = numRequired_;
+				++numRequired_;
+				if (fromPat) {
+					++numRequiredFromPats_;
+				}
+			} else {
+				hasExcludeSubStrs_ = true;
+			}
+			subStrRoles_.emplace_back(role);
+		}
+
+		/**@brief add a regex pattern, returns false and does nothing for exclude patterns that aren't simple so they can be combined
+		 *
+		 */
+		bool addPat(const std::string & pat, bool include) {
+			SimplePat simple;
+			if (parseSimplePat(pat, simple)) {
+				hasPats_ = true;
+				simpleFallbacks_.emplace_back(include, std::regex { pat });
+				simple.include_ = include;
+				const bool hasWild = std::find(simple.wild_.begin(), simple.wild_.end(), true) != simple.wild_.end();
+				if (SimplePat::Kind::CONTAINS == simple.kind_ && !hasWild) {
+					if (simple.body_.empty()) {
+						//.* matches everything
+						if (!include) {
+							simplePats_.emplace_back(simple);
+						}
+					} else {
+						addSubStr(simple.body_, include, true);
+					}
+				} else {
+					simplePats_.emplace_back(simple);
+				}
+				return true;
+			}
+			if (include) {
+				includeRegexes_.emplace_back(pat);
+				return true;
+			}
+			return false;
+		}
+	};
+
+	/**@brief Whether the character at pos is preceded by an odd number of backslashes
+	 *
+	 */
+	static bool isEscaped(const std::string & pat, size_t pos, size_t start) {
+		size_t count = 0;
+		while (pos > start && '\\' == pat[pos - 1]) {
+			++count;
+			--pos;
+		}
+		return 1 == count % 2;
+	}
+
+	static bool parseSimplePat(const std::string & pat, SimplePat & simple) {
+		static const std::string metaChars = "^$\\.*+?()[]{}|";
+		static const std::string quantifierChars = "*+?{";
+		size_t start = 0;
+		size_t stop = pat.size();
+		if (stop > start && '^' == pat[start]) {
+			++start;
+		}
+		if (stop > start && '$' == pat[stop - 1] && !isEscaped(pat, stop - 1, start)) {
+			--stop;
+		}
+		bool leadingAny = false;
+		bool trailingAny = false;
+		if (stop >= start + 2 && 0 == pat.compare(start, 2, ".*")) {
+			leadingAny = true;
+			start += 2;
+		}
+		if (stop >= start + 2 && '.' == pat[stop - 2] && '*' == pat[stop - 1] && !isEscaped(pat, stop - 2, start)) {
+			trailingAny = true;
+			stop -= 2;
+		}
+		simple.body_.clear();
+		simple.wild_.clear();
+		for (size_t pos = start; pos < stop; ++pos) {
+			const char c = pat[pos];
+			if ('\\' == c) {
+				++pos;
+				//escaped letters and digits are character classes or back references
+				if (pos >= stop || !std::ispunct(static_cast<unsigned char>(pat[pos]))) {
+					return false;
+				}
+				simple.body_.push_back(pat[pos]);
+				simple.wild_.push_back(false);
+			} else if ('.' == c) {
+				simple.body_.push_back(c);
+				simple.wild_.push_back(true);
+			} else if (std::string::npos != metaChars.find(c)) {
+				return false;
+			} else {
+				simple.body_.push_back(c);
+				simple.wild_.push_back(false);
+			}
+			if (pos + 1 < stop && std::string::npos != quantifierChars.find(pat[pos + 1])) {
+				return false;
+			}
+		}
+		if (leadingAny && trailingAny) {
+			simple.kind_ = SimplePat::Kind::CONTAINS;
+		} else if (leadingAny) {
+			simple.kind_ = SimplePat::Kind::SUFFIX;
+		} else if (trailingAny) {
+			simple.kind_ = SimplePat::Kind::PREFIX;
+		} else {
+			simple.kind_ = SimplePat::Kind::EXACT;
+		}
+		return true;
+	}
+
+	std::vector<std::string> includeSubStrs_; /**< substrings that have to be present */
+	std::vector<std::string> excludeSubStrs_; /**< substrings that can't be present */
+	std::vector<std::string> includePats_; /**< regex patterns that have to match */
+	std::vector<std::string> excludePats_; /**< regex patterns that can't match */
+	bool compiled_ = true; /**< whether compiledPatterns_ is up to date, an empty set is compiled */
+	CompiledPatterns compiledPatterns_; /**< the compiled patterns*/
+};
+
+}  // namespace njh
@@ -0,0 +1,252 @@
+#pragma once
+/*
+ * StrViewTokenizer.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include "njhcpp/utils/simdUtils.hpp"
+
+namespace njh {
+
+/**@brief Lazily split a string into std::string_view tokens without any allocation
+ *
+ * Splits on a single character, a multi-character delimiter or runs of whitespace (pass "whitespace" as the delimiter like tokenizeString()).
+ * Empty fields between delimiters are kept, a delimiter at the very end only gives an empty last field if addEmptyToEnd is true,
+ * and in whitespace mode leading/trailing whitespace is skipped with addEmptyToEnd giving an empty last field when the string ends in whitespace.
+ * The tokens point into the input so it has to outlive them.
+ *
+ */
+class StrViewTokenizer {
+public:
+	/**@brief What the string is split on
+	 *
+	 */
+	enum class DelimType {
+		CHAR, STR, WHITESPACE
+	};
+
+	/**@brief Construct with a delimiter, "whitespace" splits on runs of whitespace, a single character delimiter uses the faster character search
+	 *
+	 * @param str the string to split
+	 * @param delim the delimiter
+	 * @param addEmptyToEnd whether a delimiter at the very end gives an empty last token
+	 */
+	StrViewTokenizer(std::string_view str, std::string_view delim,
+			bool addEmptyToEnd = false) :
+			str_(str), delim_(delim), addEmptyToEnd_(addEmptyToEnd) {
+		if ("whitespace" == delim_) {
+			type_ = DelimType::WHITESPACE;
+		} else if (1 == delim_.size()) {
+			type_ = DelimType::CHAR;
+			delimChar_ = delim_.front();
+		} else {
+			type_ = DelimType::STR;
+		}
+		if (str_.empty()) {
+			pos_ = std::string_view::npos;
+		}
+	}
+
+	/**@brief Construct with a single character delimiter
+	 *
+	 * @param str the string to split
+	 * @param delim the delimiter
+	 * @param addEmptyToEnd whether a delimiter at the very end gives an empty last token
+	 */
+	StrViewTokenizer(std::string_view str, char delim, bool addEmptyToEnd = false) :
+			str_(str), delimChar_(delim), addEmptyToEnd_(addEmptyToEnd), type_(DelimType::CHAR) {
+		if (str_.empty()) {
+			pos_ = std::string_view::npos;
+		}
+	}
+
+	/**@brief Get the next token
+	 *
+	 * @param tok the view to set to the next token
+	 * @return false if there are no more tokens
+	 */
+	bool next(std::string_view & tok) {
+		if (std::string_view::npos == pos_) {
+			return false;
+		}
+		const char * const strBegin = str_.data();
+		const char * const strEnd = str_.data() + str_.size();
+		if (DelimType::WHITESPACE == type_) {
+			const char * start = simd::findNotWhitespace(strBegin + pos_, strEnd);
+			if (strEnd == start) {
+				const bool trailingWhitespace = pos_ < str_.size();
+				pos_ = std::string_view::npos;
+				if (addEmptyToEnd_ && trailingWhitespace) {
+					tok = str_.substr(str_.size(), 0);
+					return true;
+				}
+				return false;
+			}
+			const char * stop = simd::findWhitespace(start, strEnd);
+			tok = std::string_view(start, stop - start);
+			pos_ = stop - strBegin;
+			return true;
+		}
+		size_t found = std::string_view::npos;
+		if (DelimType::CHAR == type_) {
+			const char * foundPtr = simd::findChar(strBegin + pos_, strEnd, delimChar_);
+			if (strEnd != foundPtr) {
+				found = foundPtr - strBegin;
+			}
+		} else if (!delim_.empty()) {
+			found = str_.find(delim_, pos_);
+		}
+		if (std::string_view::npos == found) {
+			tok = str_.substr(pos_);
+			pos_ = std::string_view::npos;
+			return true;
+		}
+		tok = str_.substr(pos_, found - pos_);
+		pos_ = found + (DelimType::CHAR == type_ ? 1 : delim_.size());
+		if (pos_ == str_.size() && !addEmptyToEnd_) {
+			pos_ = std::string_view::npos;
+		}
+		return true;
+	}
+
+	class iterator;
+
+	/**@brief Iterate over the tokens, the tokenizer is copied so iterating doesn't advance this one
+	 *
+	 */
+	iterator begin() const;
+	iterator end() const;
+
+	/**@brief Clear toks and fill it with all the remaining tokens, meant for reusing the same vector over many lines so there's no allocation after the first line
+	 *
+	 * @param toks the vector to fill
+	 * @return the number of tokens
+	 */
+	size_t fill(std::vector<std::string_view> & toks) {
+		toks.clear();
+		std::string_view tok;
+		while (next(tok)) {
+			toks.emplace_back(tok);
+		}
+		return toks.size();
+	}
+
+	/**@brief Count the remaining tokens
+	 *
+	 * @return the number of tokens
+	 */
+	size_t count() {
+		size_t ret = 0;
+		std::string_view tok;
+		while (next(tok)) {
+			++ret;
+		}
+		return ret;
+	}
+
+	DelimType type() const {
+		return type_;
+	}
+
+private:
+	std::string_view str_; /**< the string being split */
+	std::string_view delim_; /**< the delimiter for multi-character delimiters */
+	char delimChar_ = ' '; /**< the delimiter for single character delimiters */
+	bool addEmptyToEnd_ = false; /**< whether a delimiter at the end gives an empty last token */
+	DelimType type_ = DelimType::CHAR; /**< what to split on */
+	size_t pos_ = 0; /**< where the next token starts searching, npos when done */
+};
+
+/**@brief Input iterator over the tokens, for use in range based for loops
+ *
+ */
+class StrViewTokenizer::iterator {
+public:
+	using iterator_category = std::input_iterator_tag;
+	using value_type = std::string_view;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const std::string_view *;
+	using reference = const std::string_view &;
+
+	iterator() = default;
+
+	explicit iterator(const StrViewTokenizer & tokenizer) :
+			tokenizer_(tokenizer), atEnd_(false) {
+		++(*this);
+	}
+
+	reference operator*() const {
+		return tok_;
+	}
+	pointer operator->() const {
+		return &tok_;
+	}
+	iterator & operator++() {
+		if (!tokenizer_.next(tok_)) {
+			atEnd_ = true;
+		}
+		return *this;
+	}
+	iterator operator++(int) {
+		iterator ret = *this;
+		++(*this);
+		return ret;
+	}
+	/**@brief only compares whether the iterators are at the end, like std::istream_iterator
+	 *
+	 */
+	bool operator==(const iterator & other) const {
+		return atEnd_ == other.atEnd_;
+	}
+	bool operator!=(const iterator & other) const {
+		return !(*this == other);
+	}
+
+private:
+	StrViewTokenizer tokenizer_ { std::string_view { }, ' ' };
+	std::string_view tok_;
+	bool atEnd_ = true;
+};
+
+inline StrViewTokenizer::iterator StrViewTokenizer::begin() const {
+	return iterator(*this);
+}
+
+inline StrViewTokenizer::iterator StrViewTokenizer::end() const {
+	return iterator();
+}
+
+/**@brief Split str into views, filling the reusable toks vector
+ *
+ * @param str The string to split
+ * @param delim The delimiter to split on, "whitespace" to split on runs of whitespace
+ * @param toks The vector to fill (cleared first)
+ * @param addEmptyToEnd If a delimiter is found at the very end of the str whether to end an empty string to the ret
+ * @return the number of tokens
+ */
+inline size_t tokenizeStringView(std::string_view str, std::string_view delim,
+		std::vector<std::string_view> & toks, bool addEmptyToEnd = false) {
+	return StrViewTokenizer(str, delim, addEmptyToEnd).fill(toks);
+}
+
+/**@brief Split str on a single character into views, filling the reusable toks vector
+ *
+ * @param str The string to split
+ * @param delim The character to split on
+ * @param toks The vector to fill (cleared first)
+ * @param addEmptyToEnd If a delimiter is found at the very end of the str whether to end an empty string to the ret
+ * @return the number of tokens
+ */
+inline size_t tokenizeStringView(std::string_view str, char delim,
+		std::vector<std::string_view> & toks, bool addEmptyToEnd = false) {
+	return StrViewTokenizer(str, delim, addEmptyToEnd).fill(toks);
+}
+
+}  // namespace njh
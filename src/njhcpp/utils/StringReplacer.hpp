@@ -0,0 +1,147 @@
+#pragma once
+/*
+ * StringReplacer.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <stdexcept>
+
+#include "njhcpp/utils/AhoCorasick.hpp"
+
+namespace njh {
+
+/**@brief A compiled set of pattern to replacement substitutions done in a single pass over the input, meant to be built once and reused over many strings
+ *
+ * Going left to right the leftmost occurrence is replaced with the longest pattern starting there being chosen, replaced text isn't searched again
+ * so with a single pattern this gives the same result as njh::replaceString()
+ *
+ */
+class StringReplacer {
+public:
+	StringReplacer() = default;
+
+	/**@brief Construct and compile with pattern to replacement pairs
+	 *
+	 * @param replacements the patterns (can't be empty) and what to replace them with
+	 */
+	explicit StringReplacer(const std::vector<std::pair<std::string, std::string>> & replacements) {
+		for (const auto & replacement : replacements) {
+			addReplacement(replacement.first, replacement.second);
+		}
+		compile();
+	}
+
+	/**@brief Construct and compile with a map of pattern to replacement
+	 *
+	 * @param replacements key is the pattern (can't be empty), value is the replacement
+	 */
+	explicit StringReplacer(const std::map<std::string, std::string> & replacements) {
+		for (const auto & replacement : replacements) {
+			addReplacement(replacement.first, replacement.second);
+		}
+		compile();
+	}
+
+	/**@brief Construct and compile with a map of pattern to replacement
+	 *
+	 * @param replacements key is the pattern (can't be empty), value is the replacement
+	 */
+	explicit StringReplacer(const std::unordered_map<std::string, std::string> & replacements) {
+		for (const auto & replacement : replacements) {
+			addReplacement(replacement.first, replacement.second);
+		}
+		compile();
+	}
+
+	/**@brief Add a pattern and its replacement, invalidates any previous compile, adding a pattern again just updates its replacement
+	 *
+	 * @param pattern the pattern to replace, can't be empty
+	 * @param replacement what to replace it with
+	 */
+	void addReplacement(const std::string & pattern, const std::string & replacement) {
+		auto found = patIndex_.find(pattern);
+		if (patIndex_.end() != found) {
+			replacements_[found->second] = replacement;
+			return;
+		}
+		const uint32_t patIdx = matcher_.addPattern(pattern);
+		patIndex_.emplace(pattern, patIdx);
+		replacements_.emplace_back(replacement);
+	}
+
+	/**@brief Change the replacement of an already added pattern without having to recompile
+	 *
+	 * @param pattern the pattern, has to have been added already
+	 * @param replacement the new replacement
+	 */
+	void setReplacement(const std::string & pattern, const std::string & replacement) {
+		auto found = patIndex_.find(pattern);
+		if (patIndex_.end() == found) {
+			throw std::runtime_error { std::string(__PRETTY_FUNCTION__) + ", error: no pattern " + pattern + " has been added" };
+		}
+		replacements_[found->second] = replacement;
+	}
+
+	/**@brief Build the matcher from the patterns added so far
+	 *
+	 */
+	void compile() {
+		matcher_.compile();
+	}
+
+	bool compiled() const {
+		return matcher_.compiled();
+	}
+
+	/**@brief Append str with the replacements done onto out, out is reserved to the exact final size first so it can be a reused buffer
+	 *
+	 * @param str the string to do the replacements in
+	 * @param out the string to append to
+	 * @return the number of replacements made
+	 */
+	size_t replace(std::string_view str, std::string & out) const {
+		std::vector<std::pair<uint32_t, size_t>> matches;
+		size_t finalSize = out.size() + str.size();
+		matcher_.scanLeftmostLongest(str, [this,&matches,&finalSize](uint32_t patIdx, size_t start) {
+			matches.emplace_back(patIdx, start);
+			finalSize += replacements_[patIdx].size();
+			finalSize -= matcher_.pattern(patIdx).size();
+			return true;
+		});
+		out.reserve(finalSize);
+		size_t pos = 0;
+		for (const auto & match : matches) {
+			out.append(str.data() + pos, match.second - pos);
+			out.append(replacements_[match.first]);
+			pos = match.second + matcher_.pattern(match.first).size();
+		}
+		out.append(str.data() + pos, str.size() - pos);
+		return matches.size();
+	}
+
+	/**@brief Get str with the replacements done
+	 *
+	 * @param str the string to do the replacements in
+	 * @return a new string with the replacements
+	 */
+	std::string replace(std::string_view str) const {
+		std::string ret;
+		replace(str, ret);
+		return ret;
+	}
+
+private:
+	AhoCorasick matcher_; /**< finds the patterns */
+	std::vector<std::string> replacements_; /**< replacement for each pattern index */
+	std::unordered_map<std::string, uint32_t> patIndex_; /**< pattern to its index in matcher_ */
+};
+
+}  // namespace njh
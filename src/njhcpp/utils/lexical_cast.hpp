@@ -14,6 +14,7 @@
 #include "njhcpp/common.h" //to_string, isArithmetic, isString
 #include "njhcpp/utils/typeUtils.hpp"
 #include "njhcpp/utils/stringUtils.hpp"
+#include "njhcpp/utils/numParsing.hpp"
 
 
 namespace njh {
@@ -76,7 +77,8 @@ inline std::string toSreamHelper(const std::string & source){
 }
 
 /**@brief Caster for to anything not a string, with a check for if it is a cast from
- * a string to a arithmetic type to help with scientific notation
+ * a string to a arithmetic type to help with scientific notation, string to number casts
+ * go through njh::parseNum rather than a std::stringstream
  *
  *
  */
@@ -84,6 +86,13 @@ template<class Target, class Source>
 struct lexical_caster {
 	static inline Target cast_it(const Source& source) {
 		Target ret;
+		if constexpr (isParsableNum<Target>() && std::is_convertible<const Source&, std::string_view>::value) {
+			const auto status = tryParseNum(std::string_view(source), ret);
+			if (NumParseStatus::OK == status) {
+				return ret;
+			}
+			throw bad_lexical_cast(typeStr<Target>(), typeStr<Source>() + " (\"" + std::string(std::string_view(source)) + "\", " + numParseStatusStr(status) + ")");
+		}
 		std::stringstream ss;
 		if (estd::isArithmetic<Target>() && estd::isString<Source>()) {
 			ss << toSreamHelper(source);
@@ -105,6 +114,9 @@ struct lexical_caster {
 template<class Source>
 struct lexical_caster<std::string, Source> {
 	static inline std::string cast_it(const Source& source) {
+		if constexpr (isFormattableNum<Source>()) {
+			return numToStr(source);
+		}
 		std::ostringstream oss;
 		if (oss << source) {
 			return oss.str();
@@ -144,69 +156,19 @@ OutCon lexical_cast_con(const SourceCon & con){
 
 namespace StrToNumConverter {
 
-/**@brief Function for converting a string to a number, which is just njh::lexical_cast by default and then several specific int conversions are defined for faster converting
+/**@brief Function for converting a string to a number, integer and floating point types are parsed with njh::parseNum (std::from_chars, no allocation),
+ * anything else goes through njh::lexical_cast
  *
  * @param str the string to convert
  * @return the string convert to a number
  */
 template<typename T>
-T stoToNum(const std::string &str) {
-	return njh::lexical_cast<T>(str);
-}
-
-template<>
-inline unsigned short stoToNum(const std::string &str) {
-	return estd::stous(str);
-}
-
-template<>
-inline unsigned stoToNum(const std::string &str) {
-	return estd::stou(str);
-}
-
-template<>
-inline unsigned long stoToNum(const std::string &str) {
-	return std::stoul(str);
-}
-
-template<>
-inline unsigned long long stoToNum(const std::string &str) {
-	return std::stoull(str);
-}
-
-template<>
-inline short stoToNum(const std::string &str) {
-	return estd::stos(str);
-}
-
-template<>
-inline int stoToNum(const std::string &str) {
-	return std::stoi(str);
-}
-
-template<>
-inline long int stoToNum(const std::string &str) {
-	return std::stol(str);
-}
-
-template<>
-inline long long int stoToNum(const std::string &str) {
-	return std::stoll(str);
-}
-
-template<>
-inline float stoToNum(const std::string &str) {
-	return std::stof(str);
-}
-
-template<>
-inline double stoToNum(const std::string &str) {
-	return std::stod(str);
-}
-
-template<>
-inline long double stoToNum(const std::string &str) {
-	return std::stold(str);
+T stoToNum(std::string_view str) {
+	if constexpr (isParsableNum<T>()) {
+		return parseNum<T>(str);
+	} else {
+		return njh::lexical_cast<T>(std::string(str));
+	}
 }
 
 }  // namespace StrToNumConverter
@@ -220,13 +182,15 @@ inline long double stoToNum(const std::string &str) {
  */
 template<typename T>
 std::set<T> strToSet(const std::string & str, const std::string & delim){
-	if("" == str){
-		return std::set<T>{};
-	}
-	auto toks = tokenizeString(str, delim);
 	std::set<T> ret;
-	for(const auto & tok : toks){
-		ret.emplace(lexical_cast<T>(tok));
+	StrViewTokenizer toks(str, delim);
+	std::string_view tok;
+	while (toks.next(tok)) {
+		if constexpr (isParsableNum<T>()) {
+			ret.emplace(parseNum<T>(tok));
+		} else {
+			ret.emplace(lexical_cast<T>(std::string(tok)));
+		}
 	}
 	return ret;
 }
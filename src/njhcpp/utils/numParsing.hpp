@@ -0,0 +1,286 @@
+#pragma once
+/*
+ * numParsing.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <charconv> //std::from_chars
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <cmath> //std::trunc
+#include <cstdlib> //std::strtold
+#include <cerrno>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "njhcpp/utils/typeUtils.hpp" //TypeName
+
+namespace njh {
+
+/**@brief The result of trying to parse a number out of a string
+ *
+ */
+enum class NumParseStatus {
+	OK, /**< parsed successfully */
+	EMPTY, /**< the string was empty */
+	INVALID, /**< the string doesn't start with a number */
+	TRAILING_CHARS, /**< there were characters left over after the number */
+	OUT_OF_RANGE, /**< the number doesn't fit in the requested type */
+	NOT_INTEGRAL /**< the number has a fractional part but an integer type was requested */
+};
+
+/**@brief Get a human readable reason for a parse status
+ *
+ * @param status the status
+ * @return a short description
+ */
+inline std::string numParseStatusStr(NumParseStatus status) {
+	switch (status) {
+	case NumParseStatus::OK:
+		return "ok";
+	case NumParseStatus::EMPTY:
+		return "empty string";
+	case NumParseStatus::INVALID:
+		return "not a number";
+	case NumParseStatus::TRAILING_CHARS:
+		return "extra characters after the number";
+	case NumParseStatus::OUT_OF_RANGE:
+		return "out of range";
+	case NumParseStatus::NOT_INTEGRAL:
+		return "not an integer";
+	}
+	return "unknown";
+}
+
+/**@brief Exception for a string that couldn't be parsed as a number, derives from std::invalid_argument like the std::sto* exceptions
+ *
+ */
+class bad_num_parse : public std::invalid_argument {
+public:
+	/**@brief Construct with the input and why it failed
+	 *
+	 * @param input the string that failed to parse
+	 * @param targetType the type it was being parsed into
+	 * @param status why the parsing failed
+	 */
+	bad_num_parse(std::string_view input, const std::string & targetType,
+			NumParseStatus status) :
+			std::invalid_argument(
+					"could not parse \"" + std::string(input) + "\" as " + targetType
+							+ ": " + numParseStatusStr(status)),
+			status_(status) {
+	}
+
+	/**@brief Construct with the input, why it failed and the position in a column of values
+	 *
+	 * @param input the string that failed to parse
+	 * @param targetType the type it was being parsed into
+	 * @param status why the parsing failed
+	 * @param index the position of input in the values being parsed
+	 */
+	bad_num_parse(std::string_view input, const std::string & targetType,
+			NumParseStatus status, size_t index) :
+			std::invalid_argument(
+					"could not parse value " + std::to_string(index) + ", \"" + std::string(input) + "\", as " + targetType
+							+ ": " + numParseStatusStr(status)),
+			status_(status) {
+	}
+
+	NumParseStatus status_; /**< why the parsing failed */
+};
+
+/**@brief Whether T can be parsed with njh::parseNum, all integer and floating point types except bool and char (which are read as characters)
+ *
+ */
+template<typename T>
+constexpr bool isParsableNum() {
+	using Decayed = typename std::decay<T>::type;
+	return std::is_arithmetic<Decayed>::value
+			&& !std::is_same<bool, Decayed>::value
+			&& !std::is_same<char, Decayed>::value;
+}
+
+namespace impl {
+
+/**@brief Parse a floating point number from [first, last), libstdc++'s from_chars for floating point is built on fast_float,
+ * when the standard library doesn't have floating point from_chars fall back on strtold on a null terminated copy
+ *
+ */
+template<typename T>
+NumParseStatus parseFloating(const char * first, const char * last, T & out, const char *& stop) noexcept {
+#if defined(__cpp_lib_to_chars)
+	auto res = std::from_chars(first, last, out);
+	stop = res.ptr;
+	if (std::errc::invalid_argument == res.ec) {
+		return NumParseStatus::INVALID;
+	}
+	if (std::errc::result_out_of_range == res.ec) {
+		return NumParseStatus::OUT_OF_RANGE;
+	}
+	return NumParseStatus::OK;
+#else
+	char buffer[128];
+	std::string large;
+	const char * cstr = buffer;
+	const size_t len = last - first;
+	if (len < sizeof(buffer)) {
+		std::copy(first, last, buffer);
+		buffer[len] = '\0';
+	} else {
+		large.assign(first, last);
+		cstr = large.c_str();
+	}
+	//strtold would skip leading whitespace and accept hex, from_chars doesn't
+	if (0 == len || ' ' == *first || ('\t' <= *first && *first <= '\r')
+			|| (len > 1 && '0' == first[0] && ('x' == first[1] || 'X' == first[1]))) {
+		stop = first;
+		return NumParseStatus::INVALID;
+	}
+	char * end = nullptr;
+	errno = 0;
+	const long double val = std::strtold(cstr, &end);
+	stop = first + (end - cstr);
+	if (end == cstr) {
+		return NumParseStatus::INVALID;
+	}
+	if (ERANGE == errno || (std::isfinite(val) && std::abs(val) > std::numeric_limits<T>::max())) {
+		return NumParseStatus::OUT_OF_RANGE;
+	}
+	out = static_cast<T>(val);
+	return NumParseStatus::OK;
+#endif
+}
+
+}  // namespace impl
+
+/**@brief Try to parse the whole of str as a number with no allocation and no locale, the string has to be only the number (an optional leading +
+ * is allowed), integer types also accept scientific notation or a decimal point as long as the value is a whole number (e.g. 1e6, 100.0)
+ *
+ * @param str the string to parse
+ * @param out where to put the value, only set on success
+ * @return the status of the parsing
+ */
+template<typename T>
+NumParseStatus tryParseNum(std::string_view str, T & out) noexcept {
+	static_assert(isParsableNum<T>(), "njh::tryParseNum only for integer and floating point types");
+	if (str.empty()) {
+		return NumParseStatus::EMPTY;
+	}
+	const char * first = str.data();
+	const char * const last = str.data() + str.size();
+	if ('+' == *first) {
+		++first;
+		if (first == last || '-' == *first || '+' == *first) {
+			return NumParseStatus::INVALID;
+		}
+	}
+	const char * stop = first;
+	if constexpr (std::is_integral<T>::value) {
+		T val = 0;
+		auto res = std::from_chars(first, last, val);
+		if (std::errc::invalid_argument == res.ec) {
+			return NumParseStatus::INVALID;
+		}
+		if (std::errc::result_out_of_range == res.ec) {
+			return NumParseStatus::OUT_OF_RANGE;
+		}
+		if (last == res.ptr) {
+			out = val;
+			return NumParseStatus::OK;
+		}
+		if ('.' != *res.ptr && 'e' != *res.ptr && 'E' != *res.ptr) {
+			return NumParseStatus::TRAILING_CHARS;
+		}
+		//scientific notation or a decimal point, parse as floating point and accept only whole numbers
+		long double asFloat = 0;
+		const auto status = impl::parseFloating(first, last, asFloat, stop);
+		if (NumParseStatus::OK != status) {
+			return status;
+		}
+		if (last != stop) {
+			return NumParseStatus::TRAILING_CHARS;
+		}
+		if (asFloat != std::trunc(asFloat)) {
+			return NumParseStatus::NOT_INTEGRAL;
+		}
+		if (asFloat < static_cast<long double>(std::numeric_limits<T>::min())
+				|| asFloat > static_cast<long double>(std::numeric_limits<T>::max())) {
+			return NumParseStatus::OUT_OF_RANGE;
+		}
+		out = static_cast<T>(asFloat);
+		return NumParseStatus::OK;
+	} else {
+		T val = 0;
+		const auto status = impl::parseFloating(first, last, val, stop);
+		if (NumParseStatus::OK != status) {
+			return status;
+		}
+		if (last != stop) {
+			return NumParseStatus::TRAILING_CHARS;
+		}
+		out = val;
+		return NumParseStatus::OK;
+	}
+}
+
+/**@brief Parse the whole of str as a number, throws njh::bad_num_parse on failure, see njh::tryParseNum for what is accepted
+ *
+ * @param str the string to parse
+ * @return the number
+ */
+template<typename T>
+T parseNum(std::string_view str) {
+	T ret = 0;
+	const auto status = tryParseNum(str, ret);
+	if (NumParseStatus::OK != status) {
+		throw bad_num_parse(str, TypeName::get<T>(), status);
+	}
+	return ret;
+}
+
+/**@brief Parse a range of string tokens (std::string, std::string_view or anything convertible to std::string_view) into a reusable vector,
+ * throws njh::bad_num_parse naming the position of the first token that fails
+ *
+ * @param begin the start of the tokens
+ * @param end the end of the tokens
+ * @param out the vector to fill, cleared first
+ */
+template<typename T, typename ITER>
+void parseNumColumn(ITER begin, ITER end, std::vector<T> & out) {
+	out.clear();
+	if constexpr (std::is_base_of<std::forward_iterator_tag,
+			typename std::iterator_traits<ITER>::iterator_category>::value) {
+		out.reserve(std::distance(begin, end));
+	}
+	size_t index = 0;
+	for (; begin != end; ++begin, ++index) {
+		const std::string_view tok(*begin);
+		T val = 0;
+		const auto status = tryParseNum(tok, val);
+		if (NumParseStatus::OK != status) {
+			throw bad_num_parse(tok, TypeName::get<T>(), status, index);
+		}
+		out.emplace_back(val);
+	}
+}
+
+/**@brief Parse a container of string tokens into a vector of numbers
+ *
+ * @param toks the tokens
+ * @return the parsed numbers
+ */
+template<typename T, typename CON>
+std::vector<T> parseNumColumn(const CON & toks) {
+	std::vector<T> ret;
+	parseNumColumn(toks.begin(), toks.end(), ret);
+	return ret;
+}
+
+}  // namespace njh
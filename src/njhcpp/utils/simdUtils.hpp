@@ -0,0 +1,260 @@
+#pragma once
+/*
+ * simdUtils.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: nick
+ */
+
+
+#include <cstdint>
+#include <cstring> //memchr
+#include <cctype> //toupper, tolower, isspace
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+/**AVX2 versions are compiled with target attributes and picked at run time so the library doesn't need to be built with -mavx2*/
+#define NJHCPP_SIMD_AVX2_DISPATCH 1
+#endif
+
+namespace njh {
+/**@brief Vectorized byte scanning helpers, SSE2 when available (always on x86_64) with a scalar fallback everywhere else
+ *
+ */
+namespace simd {
+
+/**@brief Whether c is whitespace as isspace() in the "C" locale would have it, ' ', \\t, \\n, \\v, \\f, \\r
+ *
+ * @param c the character to check
+ * @return true if c is whitespace
+ */
+inline bool isAsciiSpace(char c) {
+	return ' ' == c || static_cast<uint8_t>(c - '\t') <= ('\r' - '\t');
+}
+
+#if defined(__SSE2__)
+/**@brief Get a bit mask of the whitespace characters in a 16 byte block
+ *
+ */
+inline uint32_t whitespaceMask(__m128i block) {
+	const __m128i fromTab = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+	//unsigned <= 4 by checking min(x, 4) == x
+	const __m128i tabToCr = _mm_cmpeq_epi8(_mm_min_epu8(fromTab, _mm_set1_epi8('\r' - '\t')), fromTab);
+	const __m128i space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+	return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(tabToCr, space)));
+}
+#endif
+
+/**@brief Find the first occurrence of c in [begin, end)
+ *
+ * @return a pointer to the occurrence or end if not found
+ */
+inline const char * findChar(const char * begin, const char * end, char c) {
+	if (begin == end) {
+		return end;
+	}
+	//libc's memchr is already vectorized on all the platforms we build on
+	const void * found = std::memchr(begin, c, end - begin);
+	return nullptr == found ? end : static_cast<const char *>(found);
+}
+
+/**@brief Find the first whitespace character in [begin, end)
+ *
+ * @return a pointer to the whitespace or end if not found
+ */
+inline const char * findWhitespace(const char * begin, const char * end) {
+#if defined(__SSE2__)
+	while (end - begin >= 16) {
+		const uint32_t mask = whitespaceMask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin)));
+		if (0 != mask) {
+			return begin + __builtin_ctz(mask);
+		}
+		begin += 16;
+	}
+#endif
+	while (begin != end && !isAsciiSpace(*begin)) {
+		++begin;
+	}
+	return begin;
+}
+
+/**@brief Find the first non-whitespace character in [begin, end)
+ *
+ * @return a pointer to the character or end if everything is whitespace
+ */
+inline const char * findNotWhitespace(const char * begin, const char * end) {
+#if defined(__SSE2__)
+	while (end - begin >= 16) {
+		const uint32_t mask = ~whitespaceMask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin))) & 0xFFFFu;
+		if (0 != mask) {
+			return begin + __builtin_ctz(mask);
+		}
+		begin += 16;
+	}
+#endif
+	while (begin != end && isAsciiSpace(*begin)) {
+		++begin;
+	}
+	return begin;
+}
+
+/**@brief Find the first non-ASCII byte (>= 0x80) in [begin, end)
+ *
+ * @return a pointer to the byte or end if it's all ASCII
+ */
+inline const char * findNonAscii(const char * begin, const char * end) {
+#if defined(__SSE2__)
+	while (end - begin >= 16) {
+		const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin))));
+		if (0 != mask) {
+			return begin + __builtin_ctz(mask);
+		}
+		begin += 16;
+	}
+#endif
+	while (begin != end && static_cast<uint8_t>(*begin) < 0x80) {
+		++begin;
+	}
+	return begin;
+}
+
+/**@brief Find the end of [begin, end) after trailing whitespace has been removed
+ *
+ * @return a pointer one past the last non-whitespace character, begin if everything is whitespace
+ */
+inline const char * rfindNotWhitespace(const char * begin, const char * end) {
+#if defined(__SSE2__)
+	while (end - begin >= 16) {
+		const uint32_t mask = ~whitespaceMask(_mm_loadu_si128(reinterpret_cast<const __m128i *>(end - 16))) & 0xFFFFu;
+		if (0 != mask) {
+			return end - 16 + (31 - __builtin_clz(mask)) + 1;
+		}
+		end -= 16;
+	}
+#endif
+	while (begin != end && isAsciiSpace(*(end - 1))) {
+		--end;
+	}
+	return end;
+}
+
+/**@brief Whether [begin, end) is all the digits 0-9
+ *
+ */
+inline bool allDigits(const char * begin, const char * end) {
+#if defined(__SSE2__)
+	while (end - begin >= 16) {
+		const __m128i fromZero = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(begin)), _mm_set1_epi8('0'));
+		//unsigned <= 9 by checking min(x, 9) == x
+		const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(fromZero, _mm_set1_epi8(9)), fromZero);
+		if (0xFFFF != _mm_movemask_epi8(isDigit)) {
+			return false;
+		}
+		begin += 16;
+	}
+#endif
+	for (; begin != end; ++begin) {
+		if (static_cast<uint8_t>(*begin - '0') > 9) {
+			return false;
+		}
+	}
+	return true;
+}
+
+namespace impl {
+
+/**@brief Convert the case of a range with the C library toupper/tolower, used for anything with non-ASCII bytes so the current locale's rules apply to them
+ *
+ */
+template<bool TO_UPPER>
+inline void caseScalar(char * begin, char * end) {
+	for (; begin != end; ++begin) {
+		const int c = static_cast<unsigned char>(*begin);
+		*begin = static_cast<char>(TO_UPPER ? std::toupper(c) : std::tolower(c));
+	}
+}
+
+#if defined(__SSE2__)
+template<bool TO_UPPER>
+inline void caseSse2(char * begin, char * end) {
+	const __m128i lowBound = _mm_set1_epi8(TO_UPPER ? 'a' - 1 : 'A' - 1);
+	const __m128i highBound = _mm_set1_epi8(TO_UPPER ? 'z' + 1 : 'Z' + 1);
+	const __m128i flip = _mm_set1_epi8(0x20);
+	while (end - begin >= 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		if (0 != _mm_movemask_epi8(block)) {
+			caseScalar<TO_UPPER>(begin, begin + 16);
+		} else {
+			//all ASCII so the signed compares are safe
+			const __m128i inRange = _mm_and_si128(_mm_cmpgt_epi8(block, lowBound), _mm_cmplt_epi8(block, highBound));
+			block = _mm_xor_si128(block, _mm_and_si128(inRange, flip));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(begin), block);
+		}
+		begin += 16;
+	}
+	caseScalar<TO_UPPER>(begin, end);
+}
+#endif
+
+#if defined(NJHCPP_SIMD_AVX2_DISPATCH)
+template<bool TO_UPPER>
+__attribute__((target("avx2"))) inline void caseAvx2(char * begin, char * end) {
+	const __m256i lowBound = _mm256_set1_epi8(TO_UPPER ? 'a' - 1 : 'A' - 1);
+	const __m256i highBound = _mm256_set1_epi8(TO_UPPER ? 'z' + 1 : 'Z' + 1);
+	const __m256i flip = _mm256_set1_epi8(0x20);
+	while (end - begin >= 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+		if (0 != _mm256_movemask_epi8(block)) {
+			caseScalar<TO_UPPER>(begin, begin + 32);
+		} else {
+			const __m256i inRange = _mm256_and_si256(_mm256_cmpgt_epi8(block, lowBound), _mm256_cmpgt_epi8(highBound, block));
+			block = _mm256_xor_si256(block, _mm256_and_si256(inRange, flip));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(begin), block);
+		}
+		begin += 32;
+	}
+	caseSse2<TO_UPPER>(begin, end);
+}
+
+inline bool cpuHasAvx2() {
+	static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+	return hasAvx2;
+}
+#endif
+
+template<bool TO_UPPER>
+inline void convertCase(char * begin, char * end) {
+#if defined(NJHCPP_SIMD_AVX2_DISPATCH)
+	//not worth checking the cpu for short strings
+	if (end - begin >= 64 && cpuHasAvx2()) {
+		caseAvx2<TO_UPPER>(begin, end);
+		return;
+	}
+#endif
+#if defined(__SSE2__)
+	caseSse2<TO_UPPER>(begin, end);
+#else
+	caseScalar<TO_UPPER>(begin, end);
+#endif
+}
+
+}  // namespace impl
+
+/**@brief Convert [begin, end) to upper case in place, ASCII is done 16/32 bytes at a time and any block with non-ASCII bytes goes through std::toupper
+ *
+ */
+inline void toUpper(char * begin, char * end) {
+	impl::convertCase<true>(begin, end);
+}
+
+/**@brief Convert [begin, end) to lower case in place, ASCII is done 16/32 bytes at a time and any block with non-ASCII bytes goes through std::tolower
+ *
+ */
+inline void toLower(char * begin, char * end) {
+	impl::convertCase<false>(begin, end);
+}
+
+}  // namespace simd
+}  // namespace njh
@@ -18,6 +18,8 @@
 #include <iomanip> //std::setFill(), std::setw()
 #include <regex>
 #include "njhcpp/common.h" //estd::to_string
+#include "njhcpp/utils/StrViewTokenizer.hpp"
+#include "njhcpp/utils/StringReplacer.hpp"
 //#include "njhcpp/jsonUtils/jsonUtils.hpp" //included here so that most files will have json
 
 
@@ -79,6 +81,50 @@ inline std::string lstripRet(std::string str, char c){
 	return str;
 }
 
+template<typename T>
+void addAsStrToStr(std::string& str, const T& e);
+
+/**@brief Append a container onto the end of a string as delimited values in a single pass, elements are written like estd::to_string
+ * (numbers with njh::appendNum, no temporary strings), meant for reusing the same pre-reserved buffer for many rows
+ *
+ * @param out The string to append to
+ * @param con Container of values
+ * @param delim The delimiter to put between the values
+ */
+template <typename Container>
+void appendConToStr(std::string & out, const Container& con,
+                     std::string_view delim = " ") {
+  bool first = true;
+  for (const auto & e : con) {
+    if (!first) {
+      out.append(delim);
+    }
+    first = false;
+    addAsStrToStr(out, e);
+  }
+}
+
+/**@brief Append a container of floating point numbers onto the end of a string as delimited values with the given formatting
+ *
+ * @param out The string to append to
+ * @param con Container of numbers
+ * @param delim The delimiter to put between the values
+ * @param format How to write the numbers
+ * @param precision The precision to write the numbers with (ignored for FloatFormat::SHORTEST)
+ */
+template <typename Container>
+void appendConToStr(std::string & out, const Container& con,
+                     std::string_view delim, FloatFormat format, int precision = 6) {
+  bool first = true;
+  for (const auto & e : con) {
+    if (!first) {
+      out.append(delim);
+    }
+    first = false;
+    appendNum(out, e, format, precision);
+  }
+}
+
 /**@brief Take a container and change it into a delimited string
  *
  * @param con Container of values
@@ -91,6 +137,14 @@ std::string conToStr(const Container& con,
   if (con.empty()) {
     return "";
   }
+  using ValueType = typename Container::value_type;
+  //numbers and strings are written directly into the return, same output as the stream
+  if constexpr (isFormattableNum<ValueType>() || std::is_convertible<const ValueType &, std::string_view>::value) {
+    std::string ret;
+    ret.reserve(con.size() * (delim.size() + 8));
+    appendConToStr(ret, con, delim);
+    return ret;
+  }
   std::stringstream out;
   std::copy(con.begin(), con.end(),
        std::ostream_iterator<typename Container::value_type>(out, delim.c_str()));
@@ -250,44 +304,20 @@ std::string leftPadNumStr(T num, T highestNumber = 10) {
 /**@brief return a vector of strings by spiting a string on a delimiter
  *
  * @param str The string to split
- * @param delim The delimiter to split on
+ * @param delim The delimiter to split on, "whitespace" splits on runs of whitespace (with an empty string added to the end if str ends in whitespace)
  * @param addEmptyToEnd If a delimiter is found at the very end of the str whether to end an empty string to the ret
  * @return A vector of strings
+ * @note this allocates a std::string per token, use njh::StrViewTokenizer or njh::tokenizeStringView() in tight loops
  */
 inline std::vector<std::string> tokenizeString(const std::string& str,
                                                const std::string& delim,
                                                bool addEmptyToEnd = false) {
-	if("" == str){
-		return std::vector<std::string>{};
-	}
   std::vector<std::string> ret;
-  if ("whitespace" == delim) {
-    std::stringstream ss(str);
-    while (!ss.eof()) {
-      std::string tempStr;
-      ss >> tempStr;
-      ret.emplace_back(tempStr);
-    }
-  } else {
-    if (std::string::npos == str.find(delim)  ) {
-      ret.push_back(str);
-    } else {
-      std::size_t pos = str.find(delim, 0);
-      std::size_t oldPos = -delim.size();
-      while (std::string::npos != pos) {
-        ret.emplace_back(
-            str.substr(oldPos + delim.size(), pos - oldPos - delim.size()));
-        oldPos = pos;
-        pos = str.find(delim, pos + 1);
-      }
-      if (oldPos + delim.size() == str.size()) {
-        if (addEmptyToEnd) {
-          ret.emplace_back("");
-        }
-      } else {
-        ret.emplace_back(str.substr(oldPos + delim.size(), str.size() - 1));
-      }
-    }
+  //whitespace splitting always ended with an empty string for trailing whitespace
+  StrViewTokenizer toks(str, delim, "whitespace" == delim || addEmptyToEnd);
+  std::string_view tok;
+  while (toks.next(tok)) {
+    ret.emplace_back(tok);
   }
   return ret;
 }
@@ -299,12 +329,7 @@ inline std::vector<std::string> tokenizeString(const std::string& str,
  * @todo also check for negative sign and for e (for scientific notattion)
  */
 inline bool strAllDigits(const std::string& str) {
-  for (const auto& c : str) {
-    if (!isdigit(c)) {
-      return false;
-    }
-  }
-  return true;
+  return simd::allDigits(str.data(), str.data() + str.size());
 }
 
 /**@brief Just a convience to check to see if a str contains a substring
@@ -339,9 +364,7 @@ inline std::string boolToStr(bool convert) {
  * @param str String to convert
  */
 inline void strToUpper(std::string& str) {
-	for (auto& c : str) {
-		c = toupper(c);
-	}
+	simd::toUpper(str.data(), str.data() + str.size());
 }
 
 /**@brief Convert a string to all lower case letters
@@ -349,9 +372,7 @@ inline void strToUpper(std::string& str) {
  * @param str String to convert
  */
 inline void strToLower(std::string& str) {
-  for (auto& c : str) {
-    c = tolower(c);
-  }
+  simd::toLower(str.data(), str.data() + str.size());
 }
 
 /**@brief Convert a string to all upper case letters, leave original alone
@@ -384,6 +405,16 @@ inline void strVecToLower(std::vector<std::string>& vec) {
   }
 }
 
+/**@brief Convert a vector of strings to all upper case letters
+ *
+ * @param vec Vector to convert
+ */
+inline void strVecToUpper(std::vector<std::string>& vec) {
+  for (auto& v : vec) {
+    strToUpper(v);
+  }
+}
+
 /**@brief Replace a substring in a string with a new substring
  *
  * @param theString The string to do the replacement on
@@ -398,13 +429,44 @@ inline std::string replaceString(std::string theString,
 		//maybe throw? warn?
 		return theString;
 	}
-  size_t spaceSize = toBeReplaced.size();
-  size_t currPos = theString.find(toBeReplaced);
-  while (currPos != std::string::npos) {
-    theString.replace(currPos, spaceSize, replacement);
-    currPos = theString.find(toBeReplaced, currPos + replacement.size());
-  }
-  return theString;
+	size_t currPos = theString.find(toBeReplaced);
+	if (std::string::npos == currPos) {
+		return theString;
+	}
+	//build the output in one pass rather than shifting the rest of the string on every replace
+	std::string ret;
+	ret.reserve(theString.size() + (replacement.size() > toBeReplaced.size() ? replacement.size() - toBeReplaced.size() : 0) * 4);
+	size_t lastPos = 0;
+	while (currPos != std::string::npos) {
+		ret.append(theString, lastPos, currPos - lastPos);
+		ret.append(replacement);
+		lastPos = currPos + toBeReplaced.size();
+		currPos = theString.find(toBeReplaced, lastPos);
+	}
+	ret.append(theString, lastPos, std::string::npos);
+	return ret;
+}
+
+/**@brief Do several substring replacements in a single pass, see njh::StringReplacer, compile the replacer once when doing the same replacements on many strings
+ *
+ * @param theString The string to do the replacements on
+ * @param replacer The compiled replacements
+ * @return A new string with the replacements done
+ */
+inline std::string replaceString(std::string_view theString,
+                                 const StringReplacer& replacer) {
+	return replacer.replace(theString);
+}
+
+/**@brief Do several substring replacements in a single pass rather than chaining replaceString() calls
+ *
+ * @param theString The string to do the replacements on
+ * @param replacements key is the substring to be replaced, value is its replacement
+ * @return A new string with the replacements done
+ */
+inline std::string replaceStrings(std::string_view theString,
+                                 const std::map<std::string, std::string>& replacements) {
+	return StringReplacer(replacements).replace(theString);
 }
 
 /**@brief convert int to a string hex string
@@ -438,9 +500,14 @@ inline uint32_t hexToInt(const std::string& hString) {
  * @return A reference to the trimmed white space string so it can be chained with other trimming options
  */
 inline std::string &ltrim(std::string &s) {
-    // from http://stackoverflow.com/a/217605
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(),
-    		[](int c) {return !std::isspace(c);}));
+    const char * const begin = s.data();
+    const char * const end = s.data() + s.size();
+    const char * first = simd::findNotWhitespace(begin, end);
+    //non-ASCII is only whitespace in some locales, check it with isspace
+    while (end != first && static_cast<uint8_t>(*first) >= 0x80 && std::isspace(static_cast<unsigned char>(*first))) {
+      first = simd::findNotWhitespace(first + 1, end);
+    }
+    s.erase(0, first - begin);
     return s;
 }
 
@@ -450,9 +517,13 @@ inline std::string &ltrim(std::string &s) {
  * @return A reference to the trimmed white space string so it can be chained with other trimming options
  */
 inline std::string &rtrim(std::string &s) {
-    // from http://stackoverflow.com/a/217605
-    s.erase(std::find_if(s.rbegin(), s.rend(),
-    		[](int c) {return !std::isspace(c);} ).base(), s.end());
+    const char * const begin = s.data();
+    const char * last = simd::rfindNotWhitespace(begin, s.data() + s.size());
+    //non-ASCII is only whitespace in some locales, check it with isspace
+    while (begin != last && static_cast<uint8_t>(*(last - 1)) >= 0x80 && std::isspace(static_cast<unsigned char>(*(last - 1)))) {
+      last = simd::rfindNotWhitespace(begin, last - 1);
+    }
+    s.erase(last - begin);
     return s;
 }
 
@@ -462,10 +533,19 @@ inline std::string &rtrim(std::string &s) {
  * @return A reference to the trimmed white space string so it can be chained with other trimming options
  */
 inline std::string &trim(std::string& s) {
-    // from http://stackoverflow.com/a/217605
     return ltrim(rtrim(s));
 }
 
+/**@brief trim both beginning and end whitepsace of all the strings in a vector
+ *
+ * @param vec the strings to trim
+ */
+inline void strVecTrim(std::vector<std::string>& vec) {
+  for (auto& v : vec) {
+    trim(v);
+  }
+}
+
 /**@brief Get the longest string of all the elements in a container
  *
  * @param con The container
@@ -597,20 +677,35 @@ inline std::string appendAsNeededRet(std::string str, const std::string & app){
  * @return Whether str has a whitepsace character
  */
 inline bool strHasWhitesapce(const std::string & str){
-	return std::any_of(std::begin(str), std::end(str),
-			[](char c) {return std::isspace(c);});
+	const char * const end = str.data() + str.size();
+	if (end != simd::findWhitespace(str.data(), end)) {
+		return true;
+	}
+	//non-ASCII is only whitespace in some locales, check it with isspace
+	for (const char * pos = simd::findNonAscii(str.data(), end); end != pos; pos = simd::findNonAscii(pos + 1, end)) {
+		if (std::isspace(static_cast<unsigned char>(*pos))) {
+			return true;
+		}
+	}
+	return false;
 }
 
 
 template<typename T>
 void addAsStrToStr(std::string& str, const T& e) {
-	str.append(estd::to_string(e));
+	if constexpr (isFormattableNum<T>()) {
+		appendNum(str, e);
+	} else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+		str.append(std::string_view(e));
+	} else {
+		str.append(estd::to_string(e));
+	}
 }
 
 template<typename T>
 void addAsStrToStr(std::string& str, const std::vector<T>& items) {
 	for (const auto& e : items) {
-		str.append(estd::to_string(e));
+		addAsStrToStr(str, e);
 	}
 }
 